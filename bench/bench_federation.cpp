@@ -0,0 +1,62 @@
+/**
+ * @file bench_federation.cpp
+ * @brief Benchmark of federated balancers with and without shared firewall state
+ *
+ * For each node count, runs the same front-end traffic through isolated nodes
+ * (no delta exchange) and through federated nodes. Attackers spread their
+ * requests over the run, so once the front end splits them across N nodes an
+ * isolated node may never see enough of them to reach the per-IP limit.
+ * Reports aggregate throughput of front-end requests (each node runs until it
+ * has served every request it admitted), how many attackers were blocked
+ * somewhere and everywhere, and detection latency.
+ *
+ * Usage: bench_federation.exe [max_nodes] [background_requests] [attackers]
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "federation.h"
+
+int main(int argc, char* argv[]) {
+    int max_nodes = argc > 1 ? std::atoi(argv[1]) : 8;
+    int background = argc > 2 ? std::atoi(argv[2]) : 200000;
+    int attackers = argc > 3 ? std::atoi(argv[3]) : 32;
+    if (max_nodes < 1 || max_nodes > MAX_FEDERATION_NODES || background < 1 || attackers < 0) {
+        std::cerr << "Usage: " << argv[0] << " [max_nodes] [background_requests] [attackers]\n";
+        return 1;
+    }
+
+    std::cout << "Federation benchmark: " << background << " background requests, " << attackers
+              << " attackers x 80 requests, " << std::thread::hardware_concurrency() << " hardware threads\n\n";
+    std::cout << std::setw(6) << "nodes" << std::setw(11) << "mode"
+              << std::setw(12) << "req/s" << std::setw(10) << "blocked"
+              << std::setw(10) << "all nodes" << std::setw(13) << "first us"
+              << std::setw(13) << "all us" << std::setw(13) << "max all us"
+              << std::setw(10) << "batches" << std::setw(11) << "prop us"
+              << std::setw(6) << "gaps" << "\n";
+
+    for (int nodes = 1; nodes <= max_nodes; nodes *= 2) {
+        for (int share = 0; share <= 1; ++share) {
+            FederationConfig config;
+            config.nodes = nodes;
+            config.background_requests = background;
+            config.attackers = attackers;
+            config.share = share != 0;
+
+            FederationResult r = runFederation(config);
+            std::cout << std::setw(6) << nodes << std::setw(11) << (config.share ? "federated" : "isolated")
+                      << std::setw(12) << std::fixed << std::setprecision(0) << r.offered / r.seconds
+                      << std::setw(7) << r.detected_any << "/" << std::left << std::setw(2) << attackers << std::right
+                      << std::setw(7) << r.detected_all << "/" << std::left << std::setw(2) << attackers << std::right
+                      << std::setw(13) << r.first_detect_us
+                      << std::setw(13) << r.full_detect_us
+                      << std::setw(13) << r.max_full_detect_us
+                      << std::setw(10) << r.batches_sent
+                      << std::setw(11) << std::setprecision(1) << r.mean_propagation_us
+                      << std::setw(6) << r.version_gaps << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file bench_snapshot.cpp
+ * @brief Benchmark of snapshot save/restore and check that restored runs are identical
+ *
+ * Builds a warmed-up state with servers * 100 queued requests, saves it, then
+ * times restoring it. To check the snapshot is complete, the original and a
+ * restored copy both run the same number of cycles and their final snapshots
+ * are compared byte for byte.
+ *
+ * Usage: bench_snapshot.exe [servers] [cycles] [repeats]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include "loadbalancer.h"
+
+/**
+ * @brief Read a whole file into memory
+ * @param path File to read
+ * @return File contents (empty on error)
+ */
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Seconds elapsed since a start time
+ * @param start Start time
+ * @return Elapsed seconds
+ */
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int servers = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int cycles = argc > 2 ? std::atoi(argv[2]) : 200;
+    int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+    const std::string base_path = "bench_snapshot.bin";
+    const std::string a_path = "bench_snapshot_a.bin";
+    const std::string b_path = "bench_snapshot_b.bin";
+
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    LoadBalancer* original = new LoadBalancer(servers, servers * 2, 1234u);
+    for (int i = 0; i < 10; ++i) {
+        original->processCycle();
+    }
+    double cold_start = secondsSince(start);
+    int queued = original->getQueueSize();
+
+    start = std::chrono::steady_clock::now();
+    bool ok = original->saveSnapshot(base_path);
+    double save_time = secondsSince(start);
+
+    double restore_best = 0;
+    for (int r = 0; ok && r < repeats; ++r) {
+        start = std::chrono::steady_clock::now();
+        LoadBalancer* copy = LoadBalancer::fromSnapshot(base_path);
+        double t = secondsSince(start);
+        if (!copy) ok = false;
+        delete copy;
+        if (r == 0 || t < restore_best) restore_best = t;
+    }
+
+    // Run the original and a restored copy side by side and compare final states
+    bool identical = false;
+    if (ok) {
+        LoadBalancer* copy = LoadBalancer::fromSnapshot(base_path);
+        for (int i = 0; copy && i < cycles; ++i) {
+            original->processCycle();
+            copy->processCycle();
+        }
+        identical = copy && original->saveSnapshot(a_path) && copy->saveSnapshot(b_path) &&
+                    readFile(a_path) == readFile(b_path);
+        delete copy;
+    }
+    delete original;
+
+    std::cout.rdbuf(saved);
+    std::cout.clear();
+
+    std::cout << "===== Snapshot Benchmark =====\n";
+    if (!ok) {
+        std::cout << "Snapshot save/restore failed\n";
+        return 1;
+    }
+    std::cout << "Queued requests: " << queued << " | Servers: " << servers << "\n";
+    std::cout << "Cold start (construct + 10 cycles): " << cold_start * 1000 << " ms\n";
+    std::cout << "Save:             " << save_time * 1000 << " ms\n";
+    std::cout << "Restore (best):   " << restore_best * 1000 << " ms\n";
+    std::cout << "Restored run matches original after " << cycles << " cycles: "
+              << (identical ? "yes" : "NO") << "\n";
+
+    std::remove(base_path.c_str());
+    std::remove(a_path.c_str());
+    std::remove(b_path.c_str());
+    return identical ? 0 : 1;
+}
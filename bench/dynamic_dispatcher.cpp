@@ -0,0 +1,26 @@
+#include "dynamic_policies.h"
+
+// Kept apart from the RequestQueue implementations so the queue calls below
+// stay virtual
+
+namespace {
+
+/**
+ * @brief Dispatcher that pulls one request per idle server through the RequestQueue interface
+ */
+class FirstIdleDispatcher : public Dispatcher {
+public:
+    void assign(std::vector<WebServer*>& servers, RequestQueue& queue, int current_time) override {
+        for (auto* s : servers) {
+            if (!s->isBusy() && !queue.empty()) {
+                s->assignRequest(queue.pop(), current_time);
+            }
+        }
+    }
+};
+
+} // namespace
+
+Dispatcher* makeDispatcher(const std::string& name) {
+    return name == "first-idle" ? new FirstIdleDispatcher() : nullptr;
+}
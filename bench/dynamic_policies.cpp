@@ -0,0 +1,58 @@
+#include "dynamic_policies.h"
+#include "policies.h"
+
+namespace {
+
+/**
+ * @brief RequestQueue backed by FifoQueuePolicy
+ */
+class FifoRequestQueue : public RequestQueue {
+private:
+    FifoQueuePolicy impl;
+
+public:
+    void push(Request* req) override { impl.push(req); }
+    Request* pop() override { return impl.pop(); }
+    bool empty() const override { return impl.empty(); }
+    std::size_t size() const override { return impl.size(); }
+};
+
+/**
+ * @brief Firewall backed by RateLimitFirewallPolicy
+ */
+class RateLimitFirewall : public Firewall {
+private:
+    RateLimitFirewallPolicy<> impl;
+
+public:
+    bool admit(const std::string& ip) override { return impl.admit(ip); }
+    int getBlockedRequests() const override { return impl.getBlockedRequests(); }
+    int getBlockedIPCount() const override { return impl.getBlockedIPCount(); }
+};
+
+/**
+ * @brief Scaler backed by ThresholdScalePolicy
+ */
+class ThresholdScaler : public Scaler {
+private:
+    ThresholdScalePolicy<> impl;
+
+public:
+    void scale(std::vector<WebServer*>& servers, int load, int min_servers, int max_servers) override {
+        impl.scale(servers, load, min_servers, max_servers);
+    }
+};
+
+} // namespace
+
+RequestQueue* makeRequestQueue(const std::string& name) {
+    return name == "fifo" ? new FifoRequestQueue() : nullptr;
+}
+
+Firewall* makeFirewall(const std::string& name) {
+    return name == "rate-limit" ? new RateLimitFirewall() : nullptr;
+}
+
+Scaler* makeScaler(const std::string& name) {
+    return name == "threshold" ? new ThresholdScaler() : nullptr;
+}
@@ -0,0 +1,90 @@
+#ifndef DYNAMIC_POLICIES_H
+#define DYNAMIC_POLICIES_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "request.h"
+#include "webserver.h"
+
+/**
+ * @file dynamic_policies.h
+ * @brief Runtime-pluggable policy interfaces used as the baseline in bench_policies
+ *
+ * Only the abstract interfaces and factories are visible here. The
+ * implementations live in dynamic_policies.cpp and dynamic_dispatcher.cpp, so
+ * the benchmark translation unit cannot see a concrete type and the compiler
+ * cannot devirtualize or speculatively inline any call, as with policies
+ * loaded from a plugin.
+ */
+
+/**
+ * @brief Abstract request queue
+ */
+class RequestQueue {
+public:
+    virtual ~RequestQueue() {}
+    virtual void push(Request* req) = 0;
+    virtual Request* pop() = 0;
+    virtual bool empty() const = 0;
+    virtual std::size_t size() const = 0;
+};
+
+/**
+ * @brief Abstract dispatcher
+ */
+class Dispatcher {
+public:
+    virtual ~Dispatcher() {}
+    virtual void assign(std::vector<WebServer*>& servers, RequestQueue& queue, int current_time) = 0;
+};
+
+/**
+ * @brief Abstract firewall
+ */
+class Firewall {
+public:
+    virtual ~Firewall() {}
+    virtual bool admit(const std::string& ip) = 0;
+    virtual int getBlockedRequests() const = 0;
+    virtual int getBlockedIPCount() const = 0;
+};
+
+/**
+ * @brief Abstract scaler
+ */
+class Scaler {
+public:
+    virtual ~Scaler() {}
+    virtual void scale(std::vector<WebServer*>& servers, int load, int min_servers, int max_servers) = 0;
+};
+
+/**
+ * @brief Create a queue by name
+ * @param name Implementation name ("fifo")
+ * @return New queue, or nullptr if the name is unknown
+ */
+RequestQueue* makeRequestQueue(const std::string& name);
+
+/**
+ * @brief Create a dispatcher by name
+ * @param name Implementation name ("first-idle")
+ * @return New dispatcher, or nullptr if the name is unknown
+ */
+Dispatcher* makeDispatcher(const std::string& name);
+
+/**
+ * @brief Create a firewall by name
+ * @param name Implementation name ("rate-limit")
+ * @return New firewall, or nullptr if the name is unknown
+ */
+Firewall* makeFirewall(const std::string& name);
+
+/**
+ * @brief Create a scaler by name
+ * @param name Implementation name ("threshold")
+ * @return New scaler, or nullptr if the name is unknown
+ */
+Scaler* makeScaler(const std::string& name);
+
+#endif
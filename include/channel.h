@@ -0,0 +1,77 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free single-producer/single-consumer channel
+ * @tparam T Element type (moved in and out)
+ * @tparam Capacity Number of slots; must be a power of two
+ *
+ * Exactly one thread may call push() and exactly one other thread may call
+ * pop(). Neither side ever blocks: push() fails when the channel is full and
+ * pop() fails when it is empty.
+ */
+template <class T, std::size_t Capacity>
+class SpscChannel {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    // Padding keeps head and tail on separate cache lines without over-aligned
+    // types, which C++11 operator new cannot allocate
+    T slots[Capacity];                                          ///< Ring buffer storage
+    char pad_slots[64];                                         ///< Separates slots from head
+    std::atomic<std::size_t> head;                              ///< Next slot to pop (written by the consumer)
+    char pad_head[64 - sizeof(std::atomic<std::size_t>)];       ///< Separates head from tail
+    std::atomic<std::size_t> tail;                              ///< Next slot to push (written by the producer)
+    char pad_tail[64 - sizeof(std::atomic<std::size_t>)];       ///< Separates tail from neighbouring objects
+
+    SpscChannel(const SpscChannel&);
+    SpscChannel& operator=(const SpscChannel&);
+
+public:
+    SpscChannel() : head(0), tail(0) {}
+
+    /**
+     * @brief Append an element (producer only)
+     * @param value Element to move into the channel
+     * @return false if the channel is full (value is left unchanged)
+     */
+    bool push(T& value) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[t & (Capacity - 1)] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer only)
+     * @param out Destination for the element
+     * @return false if the channel is empty
+     */
+    bool pop(T& out) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = std::move(slots[h & (Capacity - 1)]);
+        slots[h & (Capacity - 1)] = T();
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Check if the channel is empty (consumer side)
+     * @return true if no element is waiting
+     */
+    bool empty() const {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef FEDERATION_H
+#define FEDERATION_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "channel.h"
+#include "loadbalancer.h"
+
+/**
+ * @file federation.h
+ * @brief Federated mode: several load balancers sharing firewall state
+ *
+ * Each balancer (node) runs on its own thread behind a shared front end that
+ * spreads requests round-robin across nodes. Nodes exchange firewall deltas
+ * (newly blocked IPs and heavy-hitter request counts) as batched, versioned
+ * FirewallDelta messages over lock-free SPSC channels, one per ordered pair
+ * of nodes. No global lock is taken.
+ */
+
+/**
+ * @brief One batch of firewall changes broadcast by a node
+ *
+ * Immutable once sent; all peers share the same instance.
+ */
+struct FirewallDelta {
+    int origin;                                         ///< Sending node
+    uint64_t version;                                   ///< Per-origin sequence number, starting at 1
+    uint64_t sent_ns;                                   ///< statsClockNs() when the batch was sent
+    std::vector<std::pair<std::string, int> > counts;   ///< Request count increments for heavy hitters
+    std::vector<std::string> blocked;                   ///< IPs newly blocked at the origin
+};
+
+const int MAX_FEDERATION_NODES = 64;   ///< Upper bound on nodes (channels grow with the square)
+
+typedef std::shared_ptr<const FirewallDelta> FirewallDeltaPtr;  ///< Shared handle to a sent batch
+typedef SpscChannel<FirewallDeltaPtr, 256> DeltaChannel;        ///< Node-to-node delta channel
+typedef SpscChannel<Request*, 4096> RequestChannel;             ///< Front-end-to-node request channel
+
+/**
+ * @brief A node's endpoints for exchanging firewall deltas with its peers
+ *
+ * Used only by the owning node's thread.
+ */
+class FederationLink {
+private:
+    int node_id;                                        ///< This node's index
+    std::vector<DeltaChannel*> outgoing;                ///< Channel to each peer (nullptr for self)
+    std::vector<DeltaChannel*> incoming;                ///< Channel from each peer (nullptr for self)
+    std::vector<std::deque<FirewallDeltaPtr> > backlog; ///< Batches waiting for space, per peer
+    std::vector<uint64_t> last_version;                 ///< Last version applied, per origin
+    uint64_t next_version;                              ///< Version for the next batch sent
+    int peers;                                          ///< Number of connected peers
+
+public:
+    uint64_t batches_sent;          ///< Batches broadcast by this node
+    uint64_t batches_received;      ///< Batches applied from peers
+    uint64_t version_gaps;          ///< Batches that arrived out of sequence
+    uint64_t propagation_ns;        ///< Sum of send-to-apply delays of received batches
+
+    /**
+     * @brief Constructor for creating an unconnected link
+     * @param id This node's index
+     * @param nodes Total number of nodes
+     */
+    FederationLink(int id, int nodes);
+
+    /**
+     * @brief Attach the channels to and from one peer
+     * @param peer Peer node index
+     * @param out Channel this node writes to the peer
+     * @param in Channel the peer writes to this node
+     */
+    void connect(int peer, DeltaChannel* out, DeltaChannel* in);
+
+    /**
+     * @brief Stamp a batch with origin, version and time and broadcast it
+     * @param delta Batch to send
+     *
+     * Batches that do not fit in a peer's channel are kept and retried in order.
+     * Without connected peers nothing is sent or counted.
+     */
+    void send(const std::shared_ptr<FirewallDelta>& delta);
+
+    /**
+     * @brief Retry batches that did not fit in a peer's channel
+     * @return true if nothing is left waiting
+     */
+    bool flushBacklog();
+
+    /**
+     * @brief Apply every batch waiting in the incoming channels
+     * @param apply Callable taking const FirewallDelta&
+     */
+    template <class Apply>
+    void receive(Apply apply) {
+        FirewallDeltaPtr delta;
+        for (std::size_t peer = 0; peer < incoming.size(); ++peer) {
+            if (!incoming[peer]) continue;
+            while (incoming[peer]->pop(delta)) {
+                if (delta->version != last_version[peer] + 1) {
+                    version_gaps++;
+                }
+                last_version[peer] = delta->version;
+                apply(*delta);
+                batches_received++;
+                propagation_ns += statsClockNs() - delta->sent_ns;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Firewall policy that shares blocklist and heavy-hitter deltas with peer balancers
+ * @tparam MaxRequestsPerIP Requests allowed per source IP across all nodes before it is blocked
+ * @tparam HeavyHitterMin Combined request count from which an IP's requests are shared
+ *
+ * Wraps RateLimitFirewallPolicy. Locally blocked IPs and request counts of
+ * heavy hitters are batched and sent on flush(); remote batches are applied
+ * on poll(). Requests admitted before an IP reaches HeavyHitterMin are not
+ * shared, so the one-off addresses that make up most traffic cost nothing
+ * extra and each node under-reports an IP by at most HeavyHitterMin - 1
+ * requests. Without a link it behaves like RateLimitFirewallPolicy.
+ */
+template <int MaxRequestsPerIP = 50, int HeavyHitterMin = 2>
+class FederatedFirewallPolicy {
+private:
+    RateLimitFirewallPolicy<MaxRequestsPerIP> local;        ///< Combined local and remote state
+    FederationLink* link;                                   ///< Peer endpoints, nullptr when isolated
+    std::map<std::string, int> pending;                     ///< Unsent local request counts of heavy hitters
+    std::vector<std::string> pending_blocked;               ///< Unsent local blocks
+    std::vector<std::pair<std::string, uint64_t> > block_log; ///< When each IP became blocked here
+
+    /**
+     * @brief Record when an IP became blocked on this node
+     * @param ip Newly blocked IP
+     */
+    void logBlock(const std::string& ip) { block_log.push_back(std::make_pair(ip, statsClockNs())); }
+
+public:
+    FederatedFirewallPolicy() : link(nullptr) {}
+
+    /**
+     * @brief Connect the firewall to its peers
+     * @param l Link owned by the same node, or nullptr to run isolated
+     */
+    void attach(FederationLink* l) { link = l; }
+
+    /**
+     * @brief Check if an IP address should be blocked
+     * @param ip IP address to check
+     * @return true if IP is blocked locally or by a peer report
+     */
+    bool isIPBlocked(const std::string& ip) const { return local.isIPBlocked(ip); }
+
+    /**
+     * @brief Decide whether a request may enter the queue, recording it for peers
+     * @param ip Source IP address of the request
+     * @return true if admitted, false if the request was blocked
+     */
+    bool admit(const std::string& ip) {
+        int blocked_before = local.getBlockedIPCount();
+        int count = 0;
+        if (local.admit(ip, &count)) {
+            if (link && count >= HeavyHitterMin) pending[ip]++;
+            return true;
+        }
+        if (local.getBlockedIPCount() > blocked_before) {
+            logBlock(ip);
+            if (link) pending_blocked.push_back(ip);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Send pending blocks and heavy-hitter counts to all peers as one batch
+     */
+    void flush() {
+        if (!link) return;
+        link->flushBacklog();
+
+        if (pending.empty() && pending_blocked.empty()) return;
+
+        std::shared_ptr<FirewallDelta> delta(new FirewallDelta());
+        delta->counts.assign(pending.begin(), pending.end());
+        delta->blocked.swap(pending_blocked);
+        pending.clear();
+        link->send(delta);
+    }
+
+    /**
+     * @brief Apply all batches received from peers
+     */
+    void poll() {
+        if (!link) return;
+        link->receive([this](const FirewallDelta& delta) {
+            for (const auto& ip : delta.blocked) {
+                if (local.blockRemote(ip)) logBlock(ip);
+            }
+            for (const auto& count : delta.counts) {
+                if (local.addRemoteCount(count.first, count.second)) logBlock(count.first);
+            }
+        });
+    }
+
+    /**
+     * @brief Get the block history of this node
+     * @return IPs in the order they were blocked, with statsClockNs() timestamps
+     */
+    const std::vector<std::pair<std::string, uint64_t> >& getBlockLog() const { return block_log; }
+
+    /**
+     * @brief Get the number of blocked requests
+     * @return Total number of requests blocked by this node's firewall
+     */
+    int getBlockedRequests() const { return local.getBlockedRequests(); }
+
+    /**
+     * @brief Get the number of blocked IP addresses
+     * @return Number of unique IPs blocked locally or by peer report
+     */
+    int getBlockedIPCount() const { return local.getBlockedIPCount(); }
+
+    /**
+     * @brief Write the firewall sections of a snapshot (unsent deltas are not saved)
+     * @param out Snapshot output stream
+     * @param header Header whose firewall fields are filled in
+     */
+    void writeSnapshot(std::ofstream& out, SnapshotHeader& header) const { local.writeSnapshot(out, header); }
+
+    /**
+     * @brief Use the firewall sections of a mapped snapshot as the initial tables
+     * @param file Mapped snapshot file
+     * @param header Validated snapshot header
+     * @return false if a section is out of bounds
+     */
+    bool attachSnapshot(const std::shared_ptr<MappedFile>& file, const SnapshotHeader& header) {
+        return local.attachSnapshot(file, header);
+    }
+};
+
+/**
+ * @brief Load balancer node used in federated mode
+ */
+typedef BasicLoadBalancer<FifoQueuePolicy,
+                          FirstIdleDispatchPolicy,
+                          FederatedFirewallPolicy<>,
+                          ThresholdScalePolicy<> > FederatedLoadBalancer;
+
+/**
+ * @brief Parameters of a federated run
+ */
+struct FederationConfig {
+    int nodes;                  ///< Number of balancer nodes (threads), 1 to MAX_FEDERATION_NODES
+    int servers_per_node;       ///< Initial servers per node (max is twice this)
+    int background_requests;    ///< Requests from random IPs
+    int attackers;              ///< Number of attacking IPs
+    int attack_requests;        ///< Requests sent by each attacker
+    int burst;                  ///< Requests a node takes from the front end per cycle
+    int flush_interval;         ///< Cycles between delta batches
+    bool share;                 ///< Exchange firewall deltas (false: isolated nodes; ignored for one node)
+    unsigned int seed;          ///< Traffic and node seed
+
+    FederationConfig()
+        : nodes(4), servers_per_node(10), background_requests(200000), attackers(32),
+          attack_requests(80), burst(4), flush_interval(16), share(true), seed(1234u) {}
+};
+
+/**
+ * @brief Measurements from a federated run
+ */
+struct FederationResult {
+    double seconds;                 ///< Wall-clock time until every node has served all admitted requests
+    uint64_t offered;               ///< Front-end requests offered to nodes
+    uint64_t admitted;              ///< Front-end requests that passed the firewall
+    uint64_t cycles;                ///< Simulation cycles summed over nodes
+    int detected_any;               ///< Attackers blocked on at least one node
+    int detected_all;               ///< Attackers blocked on every node
+    double first_detect_us;         ///< Mean time from first attack request to first block
+    double full_detect_us;          ///< Mean time from first attack request to block on every node
+    double max_full_detect_us;      ///< Worst time to block on every node
+    uint64_t batches_sent;          ///< Delta batches broadcast
+    uint64_t version_gaps;          ///< Batches received out of sequence (expected 0)
+    double mean_propagation_us;     ///< Mean delay from sending a batch to applying it
+};
+
+/**
+ * @brief Run the federated simulation
+ * @param config Run parameters
+ * @return Throughput and detection measurements
+ *
+ * Builds the front-end traffic (background plus attackers whose requests are
+ * spread over the whole run), then starts one thread per node and one front-end
+ * thread that deals requests round-robin to the nodes. Nodes generate no
+ * traffic of their own, so all work comes from the front end, and each node
+ * keeps cycling until its queue and servers are empty. Simulation output is
+ * muted while the threads run.
+ */
+FederationResult runFederation(const FederationConfig& config);
+
+#endif
@@ -2,38 +2,64 @@
 #define LOADBALANCER_H
 
 #include <vector>
-#include <queue>
 #include <string>
 #include <fstream>
-#include <map>
-#include <set>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ctime>
 #include "request.h"
 #include "webserver.h"
+#include "rng.h"
+#include "snapshot.h"
+#include "policies.h"
+#include "stats.h"
 
 /**
- * @brief Class that manages web servers and a queue of requests to simulate load balancing
+ * @brief Class template that manages web servers and a queue of requests to simulate load balancing
+ * @tparam QueuePolicy Storage for waiting requests (push/pop/empty/size)
+ * @tparam DispatchPolicy Strategy for handing queued requests to idle servers
+ * @tparam FirewallPolicy Admission control for incoming requests
+ * @tparam ScalePolicy Strategy for growing and shrinking the server pool
  * 
  * This class implements a load balancer that distributes incoming web requests across
  * multiple web servers. It includes features for dynamic server scaling, request queue
  * management, and performance monitoring. The load balancer can automatically add or
  * remove servers based on current load to maintain optimal performance.
  * 
- * Additional features include IP range blocking for firewall/DOS attack prevention.
+ * Queueing, dispatch, firewall and scaling behavior are supplied as policies resolved at
+ * compile time, so the per-cycle path contains no virtual calls. The default
+ * configuration is available as the LoadBalancer typedef.
+ * 
+ * The complete simulation state can be saved to a binary snapshot and restored
+ * from it (see snapshot.h), so long runs can be paused and experiments can
+ * branch from one warmed-up state.
+ * 
+ * Counters and per-phase cycle timings can be published to a shared-memory
+ * stats page (see stats.h) for live observation by another process.
  */
-class LoadBalancer {
+template <class QueuePolicy, class DispatchPolicy, class FirewallPolicy, class ScalePolicy>
+class BasicLoadBalancer {
 private:
-    std::queue<Request*> request_queue;         ///< Queue holding incoming requests waiting to be processed
+    QueuePolicy request_queue;                  ///< Queue holding incoming requests waiting to be processed
+    DispatchPolicy dispatcher;                  ///< Assigns queued requests to idle servers
+    FirewallPolicy firewall;                    ///< IP blocking and rate limiting
+    ScalePolicy scaler;                         ///< Adds and removes servers based on load
     std::vector<WebServer*> servers;            ///< Pool of dynamically managed web servers
     int current_time;                           ///< Current simulation clock cycle
     int min_servers;                            ///< Minimum number of servers to maintain
     int max_servers;                            ///< Maximum number of servers allowed for scaling
     int server_id_counter;                      ///< Counter for assigning unique server IDs
-    
-    // IP blocking functionality
-    std::map<std::string, int> ip_request_count; ///< Track request count per IP
-    std::set<std::string> blocked_ips;          ///< Set of blocked IP addresses
-    int blocked_requests;                       ///< Total number of blocked requests
-    int max_requests_per_ip;                    ///< Maximum requests allowed per IP before blocking
+    int starting_queue_size;                    ///< Queue size after construction or snapshot restore
+    Rng rng;                                    ///< Request generator (saved in snapshots)
+    bool print_status;                          ///< Whether processCycle() prints a status line
+    bool generate_traffic;                      ///< Whether the balancer generates its own random requests
+    std::unique_ptr<StatsPublisher> stats_page; ///< Shared-memory stats page, if enabled
+    StatsSample stats_sample;                   ///< Counters accumulated for the stats page
 
     /**
      * @brief Generate a random request for simulation
@@ -41,56 +67,97 @@ private:
      * @return Pointer to a new Request object, or nullptr if request is blocked
      */
     Request* generateRandomRequest(int arrival_time);
-    
-    /**
-     * @brief Generate a random IP address string
-     * @return String representation of a random IP address (x.x.x.x format)
-     */
-    std::string generateRandomIP();
-    
+
     /**
-     * @brief Check if an IP address should be blocked
-     * @param ip IP address to check
-     * @return true if IP should be blocked, false otherwise
+     * @brief Update the stats sample at the end of a cycle and publish it
+     * @param marks Timestamps taken at the start of each phase and at the end of the last
+     * @param admitted Requests added to the queue this cycle
+     * @param dispatched Requests assigned to servers this cycle
+     * @param busy Servers processing a request after this cycle
      */
-    bool isIPBlocked(const std::string& ip);
-    
+    void publishStats(const uint64_t* marks, uint64_t admitted, uint64_t dispatched, int busy);
+
     /**
-     * @brief Block an IP address due to suspicious activity
-     * @param ip IP address to block
+     * @brief Construct an empty load balancer to be filled from a snapshot
      */
-    void blockIP(const std::string& ip);
+    BasicLoadBalancer();
+
+    BasicLoadBalancer(const BasicLoadBalancer&);
+    BasicLoadBalancer& operator=(const BasicLoadBalancer&);
 
 public:
     /**
      * @brief Constructor for creating a new load balancer
      * @param initial_servers Number of servers to start with
      * @param max_serv Maximum number of servers allowed (default: 100)
+     * @param seed Random seed for request generation (default: 0, seed from the clock)
+     * @param generate Generate random requests (default: true); if false the
+     *        queue starts empty and requests only arrive through offerRequest()
      * 
      * Initializes the load balancer with the specified number of servers and
      * pre-fills the request queue with initial requests for simulation.
      */
-    LoadBalancer(int initial_servers, int max_serv = 100);
+    BasicLoadBalancer(int initial_servers, int max_serv = 100, unsigned int seed = 0,
+                      bool generate = true);
     
     /**
      * @brief Destructor to clean up allocated memory
      * 
-     * Properly deallocates all servers and any remaining requests in the queue.
+     * Properly deallocates all servers and any requests still in flight.
+     * Queued requests are released by the queue policy.
      */
-    ~LoadBalancer();
+    ~BasicLoadBalancer();
+
+    /**
+     * @brief Restore a load balancer from a snapshot file
+     * @param path Path of a snapshot written by saveSnapshot()
+     * @return Pointer to a new load balancer (caller deletes), or nullptr on error
+     * 
+     * The file is memory-mapped; queued requests and firewall tables are read
+     * from it in place, so restore time does not grow with queue length.
+     * Several load balancers may be restored from the same file.
+     */
+    static BasicLoadBalancer* fromSnapshot(const std::string& path);
+
+    /**
+     * @brief Save the complete simulation state to a snapshot file
+     * @param path Destination path (replaced atomically)
+     * @return true on success, false if the file could not be written
+     * 
+     * Saves the clock, random generator, servers with their in-flight requests,
+     * the request queue and the firewall tables.
+     */
+    bool saveSnapshot(const std::string& path) const;
 
     /**
      * @brief Process one simulation cycle
      * 
      * This is the main simulation method that:
      * - Increments the clock
-     * - Adds new random requests
+     * - Adds new random requests (unless traffic generation is off)
      * - Assigns requests to available servers
      * - Processes all servers
      * - Scales servers based on load
-     * - Prints current status
+     * - Publishes the stats page (if enabled)
+     * - Prints current status (unless disabled)
      */
     void processCycle();
+
+    /**
+     * @brief Start publishing counters and phase timings to a shared-memory stats page
+     * @param path Path of the stats file (e.g. /dev/shm/loadbalancer_stats)
+     * @return true on success, false if the page could not be created
+     * 
+     * Publishing is a lock-free seqlock write once per cycle; read the page
+     * with the lbstat tool.
+     */
+    bool enableStats(const std::string& path);
+
+    /**
+     * @brief Enable or disable the per-cycle status line
+     * @param enabled true to print a status line every cycle (the default)
+     */
+    void setPrintStatus(bool enabled) { print_status = enabled; }
     
     /**
      * @brief Add a new random request to the queue
@@ -100,19 +167,27 @@ public:
      */
     void addRequest();
     
+    /**
+     * @brief Offer an externally generated request to the firewall and queue
+     * @param req Request to admit (ownership is transferred)
+     * @return true if queued, false if blocked (the request is deleted)
+     * 
+     * Used when requests come from a shared front end instead of addRequest().
+     * The arrival time is set to the current clock cycle.
+     */
+    bool offerRequest(Request* req);
+    
     /**
      * @brief Assign queued requests to available servers
      * 
-     * Iterates through all servers and assigns requests from the queue
-     * to any servers that are not currently busy.
+     * Delegates to the dispatch policy.
      */
     void assignRequests();
     
     /**
      * @brief Scale servers up or down based on current load
      * 
-     * Automatically adds servers when queue size > 2x server count,
-     * and removes servers when queue is small and no servers are busy.
+     * Delegates to the scale policy.
      */
     void scaleServers();
     
@@ -141,6 +216,18 @@ public:
      */
     int getCurrentTime() const { return current_time; }
     
+    /**
+     * @brief Get the minimum number of servers
+     * @return Server count the pool never scales below
+     */
+    int getMinServers() const { return min_servers; }
+    
+    /**
+     * @brief Get the maximum number of servers
+     * @return Server count the pool never scales above
+     */
+    int getMaxServers() const { return max_servers; }
+    
     /**
      * @brief Get the total number of servers
      * @return Current number of servers (including idle and busy)
@@ -167,17 +254,372 @@ public:
      */
     void writeLogEntry(std::ofstream& log_file) const;
     
+    /**
+     * @brief Get the firewall policy instance
+     * @return Reference to the firewall, e.g. to connect a federated firewall to its peers
+     */
+    FirewallPolicy& getFirewall() { return firewall; }
+    
     /**
      * @brief Get the number of blocked requests
      * @return Total number of requests blocked by firewall
      */
-    int getBlockedRequests() const { return blocked_requests; }
+    int getBlockedRequests() const { return firewall.getBlockedRequests(); }
     
     /**
      * @brief Get the number of blocked IP addresses
      * @return Number of unique IP addresses currently blocked
      */
-    int getBlockedIPCount() const { return blocked_ips.size(); }
+    int getBlockedIPCount() const { return firewall.getBlockedIPCount(); }
 };
 
+/**
+ * @brief Generate a random IP address string
+ * @param rng Random generator to draw from
+ * @return String representation of a random IP address (x.x.x.x format)
+ */
+std::string generateRandomIP(Rng& rng);
+
+template <class Q, class D, class F, class S>
+BasicLoadBalancer<Q, D, F, S>::BasicLoadBalancer(int initial_servers, int max_serv, unsigned int seed,
+                                                 bool generate)
+    : current_time(0), min_servers(initial_servers), max_servers(max_serv), server_id_counter(0),
+      starting_queue_size(0), print_status(true), generate_traffic(generate)
+{
+    // Initialize random seed
+    rng.reseed(seed != 0 ? seed : static_cast<uint64_t>(time(nullptr)));
+    
+    std::cout << "Initializing " << min_servers << " servers..." << std::endl;
+    
+    for (int i = 0; i < min_servers; ++i) {
+        servers.push_back(new WebServer());
+    }
+    
+    if (generate_traffic) {
+        std::cout << "Pre-filling queue with " << (min_servers * 100) << " requests..." << std::endl;
+        
+        // Pre-fill queue
+        for (int i = 0; i < min_servers * 100; ++i) {
+            Request* req = generateRandomRequest(current_time);
+            if (req) {
+                request_queue.push(req);
+            }
+        }
+    }
+    starting_queue_size = request_queue.size();
+    
+    std::cout << "Load balancer initialization complete." << std::endl;
+}
+
+template <class Q, class D, class F, class S>
+BasicLoadBalancer<Q, D, F, S>::BasicLoadBalancer()
+    : current_time(0), min_servers(0), max_servers(0), server_id_counter(0), starting_queue_size(0),
+      print_status(true), generate_traffic(true)
+{
+}
+
+template <class Q, class D, class F, class S>
+BasicLoadBalancer<Q, D, F, S>::~BasicLoadBalancer() {
+    // Clean up servers and any active requests
+    for (auto* s : servers) {
+        if (s->isBusy()) {
+            Request* req = s->finishRequest();
+            if (req) delete req;
+        }
+        delete s;
+    }
+}
+
+template <class Q, class D, class F, class S>
+void BasicLoadBalancer<Q, D, F, S>::processCycle() {
+    current_time++;
+
+    // Phase timestamps and queue counts are only taken while a stats page is attached
+    uint64_t marks[PHASE_COUNT + 1] = { 0 };
+    std::size_t queued_start = 0;
+    std::size_t queued_added = 0;
+    std::size_t queued_assigned = 0;
+    if (stats_page) {
+        queued_start = request_queue.size();
+        marks[PHASE_ADD_REQUEST] = statsClockNs();
+    }
+    if (generate_traffic) addRequest();
+    if (stats_page) {
+        queued_added = request_queue.size();
+        marks[PHASE_ASSIGN] = statsClockNs();
+    }
+    assignRequests();
+    if (stats_page) {
+        queued_assigned = request_queue.size();
+        marks[PHASE_PROCESS] = statsClockNs();
+    }
+
+    // Process each server and handle completed requests
+    int busy = 0;
+    for (auto* s : servers) {
+        s->processCycle();
+        
+        // Check if server finished a request
+        if (s->isRequestDone()) {
+            Request* completed = s->finishRequest();
+            if (completed) {
+                // Log completed request (optional)
+                // std::cout << "Request completed: " << completed->ip_in << " -> " << completed->ip_out << std::endl;
+                delete completed; // Clean up completed request
+            }
+        }
+        if (stats_page && s->isBusy()) busy++;
+    }
+
+    if (stats_page) marks[PHASE_SCALE] = statsClockNs();
+    scaleServers();
+
+    if (stats_page) {
+        marks[PHASE_COUNT] = statsClockNs();
+        publishStats(marks, queued_added - queued_start, queued_added - queued_assigned, busy);
+    }
+    if (print_status) {
+        printStatus();
+    }
+}
+
+template <class Q, class D, class F, class S>
+bool BasicLoadBalancer<Q, D, F, S>::enableStats(const std::string& path) {
+    std::unique_ptr<StatsPublisher> page(new StatsPublisher());
+    if (!page->open(path)) {
+        return false;
+    }
+    
+    std::memset(&stats_sample, 0, sizeof(stats_sample));
+    stats_sample.pid = statsProcessId();
+    stats_sample.active = 1;
+    stats_page = std::move(page);
+    return true;
+}
+
+template <class Q, class D, class F, class S>
+void BasicLoadBalancer<Q, D, F, S>::publishStats(const uint64_t* marks, uint64_t admitted,
+                                                 uint64_t dispatched, int busy) {
+    StatsSample& sample = stats_sample;
+    sample.cycle = current_time;
+    sample.queue_size = request_queue.size();
+    sample.busy_servers = busy;
+    sample.total_servers = servers.size();
+    sample.blocked_requests = firewall.getBlockedRequests();
+    sample.blocked_ips = firewall.getBlockedIPCount();
+    sample.admitted_total += admitted;
+    sample.dispatched_total += dispatched;
+    sample.admission_rate_milli = statsAverage(sample.admission_rate_milli, admitted * 1000);
+    sample.dispatch_rate_milli = statsAverage(sample.dispatch_rate_milli, dispatched * 1000);
+    
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        uint64_t ns = marks[p + 1] - marks[p];
+        sample.phase_last_ns[p] = ns;
+        sample.phase_avg_ns[p] = statsAverage(sample.phase_avg_ns[p], ns);
+        if (ns > sample.phase_max_ns[p]) sample.phase_max_ns[p] = ns;
+    }
+    
+    stats_page->publish(sample);
+}
+
+template <class Q, class D, class F, class S>
+void BasicLoadBalancer<Q, D, F, S>::addRequest() {
+    // 10% chance to add a new request each tick
+    if (rng.uniform(10) == 0) {
+        Request* new_request = generateRandomRequest(current_time);
+        if (new_request) {
+            request_queue.push(new_request);
+        }
+        // If generateRandomRequest returns nullptr, the request was blocked
+    }
+}
+
+template <class Q, class D, class F, class S>
+bool BasicLoadBalancer<Q, D, F, S>::offerRequest(Request* req) {
+    if (!firewall.admit(req->ip_in)) {
+        delete req;
+        return false;
+    }
+    req->arrival_time = current_time;
+    request_queue.push(req);
+    return true;
+}
+
+template <class Q, class D, class F, class S>
+void BasicLoadBalancer<Q, D, F, S>::assignRequests() {
+    dispatcher.assign(servers, request_queue, current_time);
+}
+
+template <class Q, class D, class F, class S>
+void BasicLoadBalancer<Q, D, F, S>::scaleServers() {
+    scaler.scale(servers, request_queue.size(), min_servers, max_servers);
+}
+
+template <class Q, class D, class F, class S>
+void BasicLoadBalancer<Q, D, F, S>::printStatus() {
+    int active = getBusyServers();
+    int blocked_requests = firewall.getBlockedRequests();
+
+    std::cout << "[Cycle " << std::setw(5) << current_time << "] "
+              << "Queue: " << std::setw(4) << request_queue.size()
+              << " | Active Servers: " << std::setw(2) << active
+              << " | Total Servers: " << std::setw(2) << servers.size();
+    
+    // Add firewall status if there are blocked requests
+    if (blocked_requests > 0) {
+        std::cout << " | Blocked: " << std::setw(3) << blocked_requests 
+                  << " (" << firewall.getBlockedIPCount() << " IPs)";
+    }
+    
+    std::cout << std::endl;
+}
+
+template <class Q, class D, class F, class S>
+Request* BasicLoadBalancer<Q, D, F, S>::generateRandomRequest(int arrival_time) {
+    std::string in = generateRandomIP(rng);
+    std::string out = generateRandomIP(rng);
+    
+    // Debug: Check if IPs are valid
+    if (in.empty() || out.empty()) {
+        std::cerr << "Error: Generated empty IP address" << std::endl;
+        return nullptr;
+    }
+    
+    // Reserved ranges, blocklisted IPs and rate-limited IPs are rejected here
+    if (!firewall.admit(in)) {
+        return nullptr;
+    }
+    
+    int proc_time = 1 + rng.uniform(MAX_PROCESS_TIME); // Range: 1-10 clock cycles
+    return new Request(in, out, proc_time, arrival_time);
+}
+
+template <class Q, class D, class F, class S>
+int BasicLoadBalancer<Q, D, F, S>::getStartingQueueSize() const {
+    return starting_queue_size;
+}
+
+template <class Q, class D, class F, class S>
+int BasicLoadBalancer<Q, D, F, S>::getEndingQueueSize() const {
+    return request_queue.size();
+}
+
+template <class Q, class D, class F, class S>
+int BasicLoadBalancer<Q, D, F, S>::getBusyServers() const {
+    int busy_count = 0;
+    for (auto* s : servers) {
+        if (s->isBusy()) busy_count++;
+    }
+    return busy_count;
+}
+
+template <class Q, class D, class F, class S>
+void BasicLoadBalancer<Q, D, F, S>::writeLogEntry(std::ofstream& log_file) const {
+    log_file << current_time << ","
+             << request_queue.size() << ","
+             << getBusyServers() << ","
+             << servers.size() << ","
+             << firewall.getBlockedRequests() << ","
+             << firewall.getBlockedIPCount() << "\n";
+}
+
+template <class Q, class D, class F, class S>
+BasicLoadBalancer<Q, D, F, S>* BasicLoadBalancer<Q, D, F, S>::fromSnapshot(const std::string& path) {
+    std::shared_ptr<MappedFile> file = MappedFile::open(path);
+    if (!file) {
+        std::cerr << "Error: Could not open snapshot " << path << std::endl;
+        return nullptr;
+    }
+    
+    const SnapshotHeader* header = readSnapshotHeader(*file);
+    const ServerRecord* server_records =
+        header ? file->at<ServerRecord>(header->server_offset, header->server_count) : nullptr;
+    bool valid = server_records != nullptr;
+    for (uint64_t i = 0; valid && i < header->server_count; ++i) {
+        valid = isValidServerRecord(server_records[i]);
+    }
+    if (!valid) {
+        std::cerr << "Error: " << path << " is not a valid snapshot" << std::endl;
+        return nullptr;
+    }
+    
+    BasicLoadBalancer* lb = new BasicLoadBalancer();
+    lb->current_time = header->current_time;
+    lb->min_servers = header->min_servers;
+    lb->max_servers = header->max_servers;
+    lb->server_id_counter = header->server_id_counter;
+    lb->rng.setState(header->rng_state);
+    
+    for (uint64_t i = 0; i < header->server_count; ++i) {
+        lb->servers.push_back(unpackServer(server_records[i]));
+    }
+    
+    if (!lb->request_queue.attachSnapshot(file, *header) || !lb->firewall.attachSnapshot(file, *header)) {
+        std::cerr << "Error: " << path << " is truncated or corrupt" << std::endl;
+        delete lb;
+        return nullptr;
+    }
+    lb->starting_queue_size = lb->request_queue.size();
+    
+    return lb;
+}
+
+template <class Q, class D, class F, class S>
+bool BasicLoadBalancer<Q, D, F, S>::saveSnapshot(const std::string& path) const {
+    // Write to a temporary file first so a snapshot this run was restored from stays intact
+    std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not create snapshot " << tmp_path << std::endl;
+        return false;
+    }
+    
+    SnapshotHeader header;
+    initSnapshotHeader(header);
+    header.current_time = current_time;
+    header.min_servers = min_servers;
+    header.max_servers = max_servers;
+    header.server_id_counter = server_id_counter;
+    header.rng_state = rng.getState();
+    
+    // Placeholder header; rewritten once section offsets are known
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    header.server_offset = alignSnapshot(out);
+    header.server_count = servers.size();
+    ServerRecord server_rec;
+    for (auto* s : servers) {
+        packServer(*s, server_rec);
+        out.write(reinterpret_cast<const char*>(&server_rec), sizeof(server_rec));
+    }
+    
+    request_queue.writeSnapshot(out, header);
+    firewall.writeSnapshot(out, header);
+    
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    
+    if (out.fail() || !replaceSnapshotFile(tmp_path, path)) {
+        std::cerr << "Error: Failed to write snapshot " << path << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Default load balancer: FIFO queue, first-idle dispatch, 50-request rate limit, 2x/5 threshold scaling
+ */
+typedef BasicLoadBalancer<FifoQueuePolicy,
+                          FirstIdleDispatchPolicy,
+                          RateLimitFirewallPolicy<>,
+                          ThresholdScalePolicy<> > LoadBalancer;
+
+// The default configuration is instantiated once in src/loadbalancer.cpp
+extern template class BasicLoadBalancer<FifoQueuePolicy,
+                                        FirstIdleDispatchPolicy,
+                                        RateLimitFirewallPolicy<>,
+                                        ThresholdScalePolicy<> >;
+
 #endif
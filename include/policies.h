@@ -0,0 +1,445 @@
+#ifndef POLICIES_H
+#define POLICIES_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <map>
+#include <set>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <iostream>
+#include "request.h"
+#include "webserver.h"
+#include "snapshot.h"
+
+/**
+ * @file policies.h
+ * @brief Compile-time policies plugged into BasicLoadBalancer
+ *
+ * Each policy is a plain class with non-virtual, inline members so that the
+ * load balancer's per-cycle hot path compiles down to direct calls. Tunable
+ * thresholds are template parameters rather than runtime fields.
+ *
+ * Stateful policies also provide writeSnapshot()/attachSnapshot() so
+ * BasicLoadBalancer can save and restore them (see snapshot.h).
+ */
+
+/**
+ * @brief Check if an IP address falls inside a reserved range
+ * @param ip IP address to check
+ * @return true for 192.168.x.x, 10.x.x.x and 127.x.x.x addresses
+ */
+bool isReservedIPRange(const std::string& ip);
+
+/**
+ * @brief Queue policy that serves requests in arrival order
+ *
+ * Owns every request still waiting in the queue and deletes them on destruction.
+ * After a snapshot restore the front of the queue is read lazily from the
+ * mapped snapshot, so restore cost does not depend on queue length. Restored
+ * records that cannot be dispatched are checked and dropped as they reach
+ * the front, so size() may count a few records that are never popped.
+ */
+class FifoQueuePolicy {
+private:
+    std::deque<Request*> requests;         ///< Requests waiting to be dispatched (after the backlog)
+    std::shared_ptr<MappedFile> snapshot;  ///< Keeps the restored backlog mapped
+    const RequestRecord* backlog;          ///< Restored requests not yet materialized
+    mutable std::size_t backlog_next;      ///< Index of the next backlog record to pop
+    std::size_t backlog_size;              ///< Number of backlog records
+    mutable bool dropped_warned;           ///< Whether an invalid backlog record was reported
+
+    /**
+     * @brief Drop invalid restored records at the front of the backlog
+     */
+    void skipInvalidBacklog() const {
+        while (backlog_next < backlog_size && !isValidRequestRecord(backlog[backlog_next])) {
+            if (!dropped_warned) {
+                std::cerr << "Warning: Dropping invalid queued request(s) from snapshot" << std::endl;
+                dropped_warned = true;
+            }
+            backlog_next++;
+        }
+    }
+
+public:
+    FifoQueuePolicy() : backlog(nullptr), backlog_next(0), backlog_size(0), dropped_warned(false) {}
+    ~FifoQueuePolicy() {
+        for (auto* req : requests) {
+            delete req;
+        }
+    }
+
+    /**
+     * @brief Append a request to the back of the queue
+     * @param req Request to enqueue (ownership is transferred)
+     */
+    void push(Request* req) { requests.push_back(req); }
+
+    /**
+     * @brief Remove and return the oldest request
+     * @return Pointer to the request at the front of the queue
+     */
+    Request* pop() {
+        skipInvalidBacklog();
+        if (backlog_next < backlog_size) {
+            return unpackRequest(backlog[backlog_next++]);
+        }
+        Request* req = requests.front();
+        requests.pop_front();
+        return req;
+    }
+
+    /**
+     * @brief Check if the queue is empty
+     * @return true if no requests are waiting
+     */
+    bool empty() const {
+        skipInvalidBacklog();
+        return backlog_next == backlog_size && requests.empty();
+    }
+
+    /**
+     * @brief Get the number of waiting requests
+     * @return Current queue size
+     */
+    std::size_t size() const { return (backlog_size - backlog_next) + requests.size(); }
+
+    /**
+     * @brief Write the queue section of a snapshot, front first
+     * @param out Snapshot output stream
+     * @param header Header whose queue fields are filled in
+     */
+    void writeSnapshot(std::ofstream& out, SnapshotHeader& header) const {
+        header.queue_offset = alignSnapshot(out);
+        header.queue_count = size();
+
+        // Unconsumed backlog records are already in on-disk form
+        out.write(reinterpret_cast<const char*>(backlog + backlog_next),
+                  static_cast<std::streamsize>((backlog_size - backlog_next) * sizeof(RequestRecord)));
+
+        RequestRecord rec;
+        for (auto* req : requests) {
+            packRequest(*req, rec);
+            out.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        }
+    }
+
+    /**
+     * @brief Use the queue section of a mapped snapshot as the queue contents
+     * @param file Mapped snapshot file
+     * @param header Validated snapshot header
+     * @return false if the section is out of bounds
+     */
+    bool attachSnapshot(const std::shared_ptr<MappedFile>& file, const SnapshotHeader& header) {
+        const RequestRecord* records = file->at<RequestRecord>(header.queue_offset, header.queue_count);
+        if (!records) {
+            return false;
+        }
+        snapshot = file;
+        backlog = records;
+        backlog_next = 0;
+        backlog_size = header.queue_count;
+        return true;
+    }
+
+private:
+    FifoQueuePolicy(const FifoQueuePolicy&);
+    FifoQueuePolicy& operator=(const FifoQueuePolicy&);
+};
+
+/**
+ * @brief Dispatch policy that hands the next queued request to every idle server
+ */
+class FirstIdleDispatchPolicy {
+public:
+    /**
+     * @brief Assign queued requests to idle servers in pool order
+     * @param servers Server pool
+     * @param queue Queue policy instance to draw requests from
+     * @param current_time Current clock cycle
+     */
+    template <class Queue>
+    void assign(std::vector<WebServer*>& servers, Queue& queue, int current_time) {
+        for (auto* s : servers) {
+            if (!s->isBusy() && !queue.empty()) {
+                s->assignRequest(queue.pop(), current_time);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Firewall policy combining reserved-range blocking with per-IP rate limiting
+ * @tparam MaxRequestsPerIP Requests allowed per source IP before it is blocked
+ *
+ * After a snapshot restore the saved tables stay in the mapped file as sorted
+ * sections and are searched in place; the std::map/std::set members then only
+ * hold entries added or changed since the restore.
+ */
+template <int MaxRequestsPerIP = 50>
+class RateLimitFirewallPolicy {
+private:
+    std::map<std::string, int> ip_request_count; ///< Track request count per IP
+    std::set<std::string> blocked_ips;          ///< Set of blocked IP addresses
+    int blocked_requests;                       ///< Total number of blocked requests
+    std::shared_ptr<MappedFile> snapshot;       ///< Keeps the restored tables mapped
+    const IPCountRecord* base_counts;           ///< Restored request counts, sorted by IP
+    std::size_t base_counts_size;               ///< Number of restored request counts
+    const IPRecord* base_blocked;               ///< Restored blocked IPs, sorted
+    std::size_t base_blocked_size;              ///< Number of restored blocked IPs
+
+    /**
+     * @brief Block an IP address due to suspicious activity
+     * @param ip IP address to block
+     * @param reason Reason shown in the log line
+     */
+    void blockIP(const std::string& ip, const char* reason = "too many requests") {
+        blocked_ips.insert(ip);
+        std::cout << "  [FIREWALL] Blocked IP: " << ip << " (" << reason << ")" << std::endl;
+    }
+
+    /**
+     * @brief Get a writable request counter for an IP, creating it if needed
+     * @param ip IP address
+     * @return Reference to the IP's counter
+     */
+    int& requestCount(const std::string& ip) {
+        std::map<std::string, int>::iterator it = ip_request_count.lower_bound(ip);
+        if (it == ip_request_count.end() || it->first != ip) {
+            // First request since restore: continue from the saved count, if any
+            int previous = 0;
+            if (base_counts_size > 0) {
+                const IPCountRecord* rec = findIPCount(base_counts, base_counts_size, ip);
+                if (rec) previous = rec->count;
+            }
+            it = ip_request_count.insert(it, std::make_pair(ip, previous));
+        }
+        return it->second;
+    }
+
+public:
+    static constexpr int max_requests_per_ip = MaxRequestsPerIP; ///< Rate limit threshold
+
+    RateLimitFirewallPolicy()
+        : blocked_requests(0), base_counts(nullptr), base_counts_size(0),
+          base_blocked(nullptr), base_blocked_size(0) {}
+
+    /**
+     * @brief Check if an IP address should be blocked
+     * @param ip IP address to check
+     * @return true if IP is on the blocklist or in a reserved range
+     */
+    bool isIPBlocked(const std::string& ip) const {
+        // Check if IP is empty or too short
+        if (ip.empty() || ip.length() < 7) {
+            return false;
+        }
+        if (blocked_ips.find(ip) != blocked_ips.end()) {
+            return true;
+        }
+        if (base_blocked_size > 0 && containsIP(base_blocked, base_blocked_size, ip)) {
+            return true;
+        }
+        return isReservedIPRange(ip);
+    }
+
+    /**
+     * @brief Decide whether a request from the given source IP may enter the queue
+     * @param ip Source IP address of the request
+     * @param count_out If not null, receives the IP's request count after an admitted request
+     * @return true if admitted, false if the request was blocked
+     *
+     * Counts the request against the IP and blocks the IP once it exceeds
+     * MaxRequestsPerIP.
+     */
+    bool admit(const std::string& ip, int* count_out = nullptr) {
+        if (isIPBlocked(ip)) {
+            blocked_requests++;
+            return false;
+        }
+
+        int count = ++requestCount(ip);
+        if (count_out) *count_out = count;
+        if (count > max_requests_per_ip) {
+            blockIP(ip);
+            blocked_requests++;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Count requests seen for an IP by another balancer
+     * @param ip Source IP address
+     * @param delta Number of requests to add
+     * @return true if the combined count pushed the IP over the limit and it was blocked
+     */
+    bool addRemoteCount(const std::string& ip, int delta) {
+        if (isIPBlocked(ip)) {
+            return false;
+        }
+        int& count = requestCount(ip);
+        count += delta;
+        if (count > max_requests_per_ip) {
+            blockIP(ip, "too many requests across balancers");
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Block an IP reported by another balancer
+     * @param ip IP address to block
+     * @return true if the IP was not blocked before
+     */
+    bool blockRemote(const std::string& ip) {
+        if (isIPBlocked(ip)) {
+            return false;
+        }
+        blockIP(ip, "reported by peer");
+        return true;
+    }
+
+    /**
+     * @brief Get the number of blocked requests
+     * @return Total number of requests blocked by firewall
+     */
+    int getBlockedRequests() const { return blocked_requests; }
+
+    /**
+     * @brief Get the number of blocked IP addresses
+     * @return Number of unique IP addresses currently blocked
+     */
+    int getBlockedIPCount() const { return blocked_ips.size() + base_blocked_size; }
+
+    /**
+     * @brief Write the firewall sections of a snapshot
+     * @param out Snapshot output stream
+     * @param header Header whose firewall fields are filled in
+     *
+     * Merges restored and live entries so both sections stay sorted by IP.
+     */
+    void writeSnapshot(std::ofstream& out, SnapshotHeader& header) const {
+        header.blocked_requests = blocked_requests;
+
+        header.ip_count_offset = alignSnapshot(out);
+        header.ip_count_count = 0;
+        IPCountRecord count_rec;
+        std::size_t b = 0;
+        std::map<std::string, int>::const_iterator it = ip_request_count.begin();
+        while (b < base_counts_size || it != ip_request_count.end()) {
+            int order = (b == base_counts_size) ? 1
+                      : (it == ip_request_count.end()) ? -1
+                      : -compareIP(it->first, base_counts[b].ip);
+            if (order < 0) {
+                count_rec = base_counts[b++];
+            } else {
+                // Live entries supersede the restored entry for the same IP
+                if (order == 0) b++;
+                packIP(it->first, count_rec.ip);
+                count_rec.count = it->second;
+                ++it;
+            }
+            out.write(reinterpret_cast<const char*>(&count_rec), sizeof(count_rec));
+            header.ip_count_count++;
+        }
+
+        header.blocked_ip_offset = alignSnapshot(out);
+        header.blocked_ip_count = 0;
+        IPRecord ip_rec;
+        b = 0;
+        std::set<std::string>::const_iterator bit = blocked_ips.begin();
+        while (b < base_blocked_size || bit != blocked_ips.end()) {
+            int order = (b == base_blocked_size) ? 1
+                      : (bit == blocked_ips.end()) ? -1
+                      : -compareIP(*bit, base_blocked[b].ip);
+            if (order < 0) {
+                ip_rec = base_blocked[b++];
+            } else {
+                if (order == 0) b++;
+                packIP(*bit, ip_rec.ip);
+                ++bit;
+            }
+            out.write(reinterpret_cast<const char*>(&ip_rec), sizeof(ip_rec));
+            header.blocked_ip_count++;
+        }
+    }
+
+    /**
+     * @brief Use the firewall sections of a mapped snapshot as the initial tables
+     * @param file Mapped snapshot file
+     * @param header Validated snapshot header
+     * @return false if a section is out of bounds
+     */
+    bool attachSnapshot(const std::shared_ptr<MappedFile>& file, const SnapshotHeader& header) {
+        const IPCountRecord* counts = file->at<IPCountRecord>(header.ip_count_offset, header.ip_count_count);
+        const IPRecord* blocked = file->at<IPRecord>(header.blocked_ip_offset, header.blocked_ip_count);
+        if (!counts || !blocked) {
+            return false;
+        }
+        ip_request_count.clear();
+        blocked_ips.clear();
+        blocked_requests = static_cast<int>(header.blocked_requests);
+        snapshot = file;
+        base_counts = counts;
+        base_counts_size = header.ip_count_count;
+        base_blocked = blocked;
+        base_blocked_size = header.blocked_ip_count;
+        return true;
+    }
+};
+
+template <int MaxRequestsPerIP>
+constexpr int RateLimitFirewallPolicy<MaxRequestsPerIP>::max_requests_per_ip;
+
+/**
+ * @brief Scale policy that adds or removes one server per cycle based on queue length
+ * @tparam ScaleUpFactor Add a server when queue size exceeds this multiple of the server count
+ * @tparam ScaleDownQueue Remove a server when queue size is at or below this value and no server is busy
+ */
+template <int ScaleUpFactor = 2, int ScaleDownQueue = 5>
+class ThresholdScalePolicy {
+public:
+    static constexpr int scale_up_factor = ScaleUpFactor;   ///< Queue-to-server ratio that triggers scale up
+    static constexpr int scale_down_queue = ScaleDownQueue; ///< Queue size at or below which scale down may occur
+
+    /**
+     * @brief Scale the server pool up or down by one server
+     * @param servers Server pool to resize
+     * @param load Current queue size
+     * @param min_servers Minimum number of servers to maintain
+     * @param max_servers Maximum number of servers allowed
+     */
+    void scale(std::vector<WebServer*>& servers, int load, int min_servers, int max_servers) {
+        int active = servers.size();
+        int busy_servers = 0;
+
+        // Count busy servers
+        for (auto* s : servers) {
+            if (s->isBusy()) busy_servers++;
+        }
+
+        // If overloaded, add a server (up to max)
+        if (load > active * scale_up_factor && active < max_servers) {
+            servers.push_back(new WebServer());
+            std::cout << "  [SCALE UP] Added server. Total: " << servers.size() << std::endl;
+        }
+        // If underloaded and more than min servers, remove one (only if no busy servers)
+        else if (load <= scale_down_queue && active > min_servers && busy_servers == 0) {
+            delete servers.back();
+            servers.pop_back();
+            std::cout << "  [SCALE DOWN] Removed server. Total: " << servers.size() << std::endl;
+        }
+    }
+};
+
+template <int ScaleUpFactor, int ScaleDownQueue>
+constexpr int ThresholdScalePolicy<ScaleUpFactor, ScaleDownQueue>::scale_up_factor;
+
+template <int ScaleUpFactor, int ScaleDownQueue>
+constexpr int ThresholdScalePolicy<ScaleUpFactor, ScaleDownQueue>::scale_down_queue;
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <string>
 
+const int MAX_PROCESS_TIME = 10;    ///< Longest request processing time in clock cycles
+
 /**
  * @brief Struct to represent a web request in the load balancer system
  * 
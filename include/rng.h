@@ -0,0 +1,60 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+/**
+ * @brief Small deterministic pseudo-random number generator (xorshift64*)
+ *
+ * Used by the load balancer instead of rand() so the complete generator
+ * state is a single 64-bit word that can be saved and restored.
+ */
+class Rng {
+private:
+    uint64_t state; ///< Current generator state (never zero)
+
+public:
+    /**
+     * @brief Constructor for creating a new generator
+     * @param seed Initial seed (default: 1)
+     */
+    explicit Rng(uint64_t seed = 1) { reseed(seed); }
+
+    /**
+     * @brief Reset the generator from a seed
+     * @param seed New seed; zero is replaced by a fixed non-zero constant
+     */
+    void reseed(uint64_t seed) { state = seed != 0 ? seed : 0x9E3779B97F4A7C15ULL; }
+
+    /**
+     * @brief Produce the next 32 random bits
+     * @return Uniformly distributed 32-bit value
+     */
+    uint32_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<uint32_t>((state * 2685821657736338717ULL) >> 32);
+    }
+
+    /**
+     * @brief Produce a random integer in [0, n)
+     * @param n Exclusive upper bound (must be positive)
+     * @return Random integer in range
+     */
+    int uniform(int n) { return static_cast<int>(next() % static_cast<uint32_t>(n)); }
+
+    /**
+     * @brief Get the raw generator state
+     * @return State word suitable for setState()
+     */
+    uint64_t getState() const { return state; }
+
+    /**
+     * @brief Restore a raw generator state
+     * @param s State previously returned by getState()
+     */
+    void setState(uint64_t s) { reseed(s); }
+};
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include "request.h"
+#include "webserver.h"
+
+/**
+ * @file snapshot.h
+ * @brief Binary snapshot format for saving and restoring simulation state
+ *
+ * A snapshot is a header followed by fixed-size record sections (servers,
+ * queued requests, per-IP request counts, blocked IPs), each aligned to 8
+ * bytes. Records are plain structs so a restored snapshot can be read in
+ * place from a memory-mapped file. Queue and firewall sections are written
+ * in the order their owners need, so restore does not sort or copy them.
+ * The format uses native byte order and is meant to be read back on the
+ * machine that wrote it.
+ */
+
+const uint32_t SNAPSHOT_VERSION = 1;        ///< Current snapshot format version
+const std::size_t SNAPSHOT_IP_LEN = 16;     ///< Fixed IP field width (15 characters + terminator)
+
+/**
+ * @brief Snapshot file header
+ */
+struct SnapshotHeader {
+    char magic[8];                  ///< "LBSNAP" followed by two zero bytes
+    uint32_t version;               ///< Format version (SNAPSHOT_VERSION)
+    uint32_t header_size;           ///< sizeof(SnapshotHeader) of the writer
+    uint32_t server_record_size;    ///< sizeof(ServerRecord) of the writer
+    uint32_t request_record_size;   ///< sizeof(RequestRecord) of the writer
+    uint32_t ip_count_record_size;  ///< sizeof(IPCountRecord) of the writer
+    uint32_t ip_record_size;        ///< sizeof(IPRecord) of the writer
+    int32_t current_time;           ///< Simulation clock
+    int32_t min_servers;            ///< Minimum number of servers to maintain
+    int32_t max_servers;            ///< Maximum number of servers allowed
+    int32_t server_id_counter;      ///< Counter for assigning unique server IDs
+    uint64_t rng_state;             ///< Request generator state
+    int64_t blocked_requests;       ///< Total number of blocked requests
+    uint64_t server_offset;         ///< File offset of the server section
+    uint64_t server_count;          ///< Number of ServerRecord entries
+    uint64_t queue_offset;          ///< File offset of the queue section (front first)
+    uint64_t queue_count;           ///< Number of RequestRecord entries
+    uint64_t ip_count_offset;       ///< File offset of the per-IP count section (sorted by IP)
+    uint64_t ip_count_count;        ///< Number of IPCountRecord entries
+    uint64_t blocked_ip_offset;     ///< File offset of the blocked IP section (sorted by IP)
+    uint64_t blocked_ip_count;      ///< Number of IPRecord entries
+};
+
+/**
+ * @brief Serialized Request
+ */
+struct RequestRecord {
+    char ip_in[SNAPSHOT_IP_LEN];    ///< Source IP, zero terminated
+    char ip_out[SNAPSHOT_IP_LEN];   ///< Destination IP, zero terminated
+    int32_t process_time;           ///< Processing time in clock cycles
+    int32_t arrival_time;           ///< Clock cycle when the request entered the queue
+    int32_t assigned_time;          ///< Clock cycle when assigned to a server (-1 if not assigned)
+    int32_t processed;              ///< Non-zero if the request has been completed
+};
+
+/**
+ * @brief Serialized WebServer including its in-flight request
+ */
+struct ServerRecord {
+    int32_t busy;                   ///< Non-zero if the server is processing a request
+    int32_t time_remaining;         ///< Cycles left on the current request
+    int32_t has_request;            ///< Non-zero if request holds a valid record
+    int32_t reserved;               ///< Padding, always zero
+    RequestRecord request;          ///< Current request (valid only if has_request)
+};
+
+/**
+ * @brief Serialized firewall request counter for one IP
+ */
+struct IPCountRecord {
+    char ip[SNAPSHOT_IP_LEN];       ///< Source IP, zero terminated
+    int32_t count;                  ///< Requests seen from this IP
+};
+
+/**
+ * @brief Serialized blocked IP
+ */
+struct IPRecord {
+    char ip[SNAPSHOT_IP_LEN];       ///< Blocked IP, zero terminated
+};
+
+/**
+ * @brief Read-only view of a snapshot file, memory-mapped where available
+ *
+ * Shared by every component that reads records in place, so the mapping
+ * lives until the last of them is done with it.
+ */
+class MappedFile {
+private:
+    const char* bytes;          ///< Start of the file contents
+    std::size_t length;         ///< File size in bytes
+    std::vector<char> buffer;   ///< File contents on platforms without mmap
+
+    MappedFile();
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+public:
+    ~MappedFile();
+
+    /**
+     * @brief Map a file for reading
+     * @param path Path to the file
+     * @return Shared handle to the mapping, or nullptr if the file could not be opened
+     */
+    static std::shared_ptr<MappedFile> open(const std::string& path);
+
+    /**
+     * @brief Get the file size
+     * @return Size of the mapped file in bytes
+     */
+    std::size_t size() const { return length; }
+
+    /**
+     * @brief Get a typed pointer to an array of records inside the file
+     * @param offset Byte offset of the first record
+     * @param count Number of records
+     * @return Pointer to the records, or nullptr if the range is out of bounds or misaligned
+     */
+    template <class T>
+    const T* at(uint64_t offset, uint64_t count) const {
+        if (offset > length || offset % alignof(T) != 0) {
+            return nullptr;
+        }
+        if (count > (length - offset) / sizeof(T)) {
+            return nullptr;
+        }
+        return reinterpret_cast<const T*>(bytes + offset);
+    }
+};
+
+/**
+ * @brief Validate and return the header of a mapped snapshot
+ * @param file Mapped snapshot file
+ * @return Pointer to the header, or nullptr if the file is not a compatible snapshot
+ *         or its clock and server limits are inconsistent
+ */
+const SnapshotHeader* readSnapshotHeader(const MappedFile& file);
+
+/**
+ * @brief Fill in the magic, version and record layout fields of a new header
+ * @param header Header to initialize (all other fields are zeroed)
+ */
+void initSnapshotHeader(SnapshotHeader& header);
+
+/**
+ * @brief Pad the output stream to the next 8-byte boundary
+ * @param out Snapshot output stream
+ * @return Offset of the aligned position
+ */
+uint64_t alignSnapshot(std::ofstream& out);
+
+/**
+ * @brief Copy an IP string into a fixed-width record field
+ * @param ip IP address string (at most 15 characters)
+ * @param field Destination field, zero padded
+ */
+void packIP(const std::string& ip, char* field);
+
+/**
+ * @brief Compare an IP string with a fixed-width record field
+ * @param ip IP address string
+ * @param field Zero-terminated record field
+ * @return Negative, zero or positive as ip orders before, equal to or after field
+ *
+ * Uses the same ordering as std::string, so sections written from a
+ * std::map or std::set can be binary searched with it.
+ */
+int compareIP(const std::string& ip, const char* field);
+
+/**
+ * @brief Serialize a request
+ * @param req Request to serialize
+ * @param rec Destination record
+ */
+void packRequest(const Request& req, RequestRecord& rec);
+
+/**
+ * @brief Create a request from its serialized form
+ * @param rec Source record
+ * @return Pointer to a new Request object
+ */
+Request* unpackRequest(const RequestRecord& rec);
+
+/**
+ * @brief Serialize a server and its in-flight request
+ * @param server Server to serialize
+ * @param rec Destination record
+ */
+void packServer(const WebServer& server, ServerRecord& rec);
+
+/**
+ * @brief Check that a request record can be dispatched
+ * @param rec Record to check
+ * @return false if the processing time is outside 1..MAX_PROCESS_TIME
+ */
+bool isValidRequestRecord(const RequestRecord& rec);
+
+/**
+ * @brief Check that a server record describes a consistent server
+ * @param rec Record to check
+ * @return false if the server is busy without a request or with time remaining
+ *         outside 1..process_time, is idle but holds an unfinished request, or
+ *         holds an invalid request
+ */
+bool isValidServerRecord(const ServerRecord& rec);
+
+/**
+ * @brief Create a server from its serialized form
+ * @param rec Source record
+ * @return Pointer to a new WebServer object
+ */
+WebServer* unpackServer(const ServerRecord& rec);
+
+/**
+ * @brief Binary search a sorted IPCountRecord section
+ * @param records First record
+ * @param count Number of records
+ * @param ip IP address to look up
+ * @return Matching record, or nullptr if not present
+ */
+const IPCountRecord* findIPCount(const IPCountRecord* records, std::size_t count, const std::string& ip);
+
+/**
+ * @brief Binary search a sorted IPRecord section
+ * @param records First record
+ * @param count Number of records
+ * @param ip IP address to look up
+ * @return true if the IP is present
+ */
+bool containsIP(const IPRecord* records, std::size_t count, const std::string& ip);
+
+/**
+ * @brief Replace a file with a freshly written temporary file
+ * @param tmp_path Path of the completed temporary file
+ * @param path Destination path
+ * @return true on success
+ *
+ * Renaming instead of truncating in place keeps any existing mapping of
+ * the destination (e.g. the snapshot this run was restored from) valid.
+ */
+bool replaceSnapshotFile(const std::string& tmp_path, const std::string& path);
+
+#endif
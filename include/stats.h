@@ -0,0 +1,154 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * @file stats.h
+ * @brief Shared-memory statistics page for observing a running simulation
+ *
+ * The load balancer publishes a StatsSample once per cycle into a small
+ * memory-mapped file. Publishing is a seqlock write: no I/O, no locks and no
+ * allocation on the simulation thread. Readers in other processes retry until
+ * they see a consistent copy (see readStats() and tools/lbstat.cpp).
+ */
+
+/**
+ * @brief Phases of LoadBalancer::processCycle() that are timed
+ */
+enum StatsPhase {
+    PHASE_ADD_REQUEST = 0,  ///< addRequest()
+    PHASE_ASSIGN,           ///< assignRequests()
+    PHASE_PROCESS,          ///< Server processing loop
+    PHASE_SCALE,            ///< scaleServers()
+    PHASE_COUNT             ///< Number of timed phases
+};
+
+/**
+ * @brief One consistent set of counters; every field is a 64-bit word
+ */
+struct StatsSample {
+    uint64_t pid;                           ///< Process ID of the publisher
+    uint64_t active;                        ///< 1 while the publisher is running, 0 after it closes
+    uint64_t cycle;                         ///< Current simulation clock cycle
+    uint64_t queue_size;                    ///< Requests waiting in the queue
+    uint64_t busy_servers;                  ///< Servers processing a request
+    uint64_t total_servers;                 ///< Servers in the pool
+    uint64_t blocked_requests;              ///< Requests rejected by the firewall
+    uint64_t blocked_ips;                   ///< IPs on the blocklist
+    uint64_t admitted_total;                ///< Requests added to the queue since start
+    uint64_t dispatched_total;              ///< Requests assigned to servers since start
+    uint64_t admission_rate_milli;          ///< Moving average of admissions per cycle, x1000
+    uint64_t dispatch_rate_milli;           ///< Moving average of dispatches per cycle, x1000
+    uint64_t phase_last_ns[PHASE_COUNT];    ///< Duration of each phase in the last cycle
+    uint64_t phase_avg_ns[PHASE_COUNT];     ///< Moving average duration of each phase
+    uint64_t phase_max_ns[PHASE_COUNT];     ///< Longest duration of each phase since start
+};
+
+const uint64_t STATS_MAGIC = 0x54415453424C0001ULL;                     ///< Identifies a stats page
+const std::size_t STATS_WORDS = sizeof(StatsSample) / sizeof(uint64_t); ///< Words in a sample
+
+/**
+ * @brief Layout of the shared-memory stats page
+ *
+ * sequence is odd while a write is in progress. All fields are atomics so
+ * concurrent reads are well defined; the seqlock makes the data words
+ * consistent. magic is written last with release order when the page is
+ * (re)initialized, so a reader that loads it with acquire order sees the rest.
+ */
+struct StatsPage {
+    std::atomic<uint64_t> magic;                ///< STATS_MAGIC once the page is initialized
+    std::atomic<uint64_t> words_count;          ///< STATS_WORDS of the writer
+    std::atomic<uint64_t> sequence;             ///< Seqlock sequence number
+    std::atomic<uint64_t> words[STATS_WORDS];   ///< StatsSample contents
+};
+
+// Atomics in memory shared between processes must not fall back to a lock
+// (uint64_t is unsigned long on LP64 and unsigned long long elsewhere, so check both)
+static_assert(ATOMIC_LONG_LOCK_FREE == 2 || sizeof(unsigned long) != sizeof(uint64_t),
+              "64-bit atomics must be lock-free to share the stats page");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 || sizeof(unsigned long long) != sizeof(uint64_t),
+              "64-bit atomics must be lock-free to share the stats page");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "stats page words must be plain 64-bit values");
+
+/**
+ * @brief Get a monotonic timestamp for phase timing
+ * @return Nanoseconds from an arbitrary fixed point
+ */
+uint64_t statsClockNs();
+
+/**
+ * @brief Get the ID of the current process
+ * @return Process ID (0 where unsupported)
+ */
+uint64_t statsProcessId();
+
+/**
+ * @brief Fold a new value into an exponential moving average (weight 1/16)
+ * @param avg Current average
+ * @param value New observation
+ * @return Updated average
+ */
+inline uint64_t statsAverage(uint64_t avg, uint64_t value) {
+    int64_t delta = static_cast<int64_t>(value) - static_cast<int64_t>(avg);
+    return static_cast<uint64_t>(static_cast<int64_t>(avg) + delta / 16);
+}
+
+/**
+ * @brief Take a consistent copy of a stats page
+ * @param page Mapped stats page
+ * @param sample Destination for the copy
+ * @param max_retries Attempts before giving up while a writer is active
+ * @return true if a consistent copy was read
+ */
+bool readStats(const StatsPage& page, StatsSample& sample, int max_retries = 1000);
+
+/**
+ * @brief Writer side of a stats page
+ *
+ * Owns the mapping of the stats file. publish() is the only call made from
+ * the simulation thread.
+ */
+class StatsPublisher {
+private:
+    StatsPage* page;    ///< Mapped stats page, nullptr until open() succeeds
+
+    StatsPublisher(const StatsPublisher&);
+    StatsPublisher& operator=(const StatsPublisher&);
+
+public:
+    StatsPublisher() : page(nullptr) {}
+
+    /**
+     * @brief Destructor marks the page inactive and unmaps it
+     */
+    ~StatsPublisher();
+
+    /**
+     * @brief Create or reuse the stats file and map it
+     * @param path Path of the stats file (e.g. under /dev/shm)
+     * @return true on success, false if the file could not be created or mapped
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Publish a sample with a seqlock write
+     * @param sample Counters to publish
+     */
+    void publish(const StatsSample& sample) {
+        const uint64_t* src = reinterpret_cast<const uint64_t*>(&sample);
+        uint64_t seq = page->sequence.load(std::memory_order_relaxed);
+
+        page->sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < STATS_WORDS; ++i) {
+            page->words[i].store(src[i], std::memory_order_relaxed);
+        }
+        page->sequence.store(seq + 2, std::memory_order_release);
+    }
+};
+
+#endif
@@ -28,7 +28,7 @@ public:
      * @brief Check if the server is currently busy
      * @return true if server is processing a request, false otherwise
      */
-    bool isBusy() const;
+    bool isBusy() const { return busy; }
     
     /**
      * @brief Assign a new request to this server
@@ -45,13 +45,21 @@ public:
      * Decrements the remaining processing time for the current request.
      * If processing time reaches zero, marks the request as completed.
      */
-    void processCycle();
+    void processCycle() {
+        if (busy && time_remaining > 0) {
+            time_remaining--;
+            if (time_remaining == 0) {
+                busy = false;
+                current_request->processed = true;
+            }
+        }
+    }
     
     /**
      * @brief Check if the current request is finished
      * @return true if request is completed, false otherwise
      */
-    bool isRequestDone() const;
+    bool isRequestDone() const { return !busy && current_request != nullptr && current_request->processed; }
     
     /**
      * @brief Finish and return the completed request
@@ -61,6 +69,26 @@ public:
      * It returns the request pointer and resets the server to idle state.
      */
     Request* finishRequest();
+
+    /**
+     * @brief Get the remaining processing time
+     * @return Clock cycles left on the current request
+     */
+    int getTimeRemaining() const { return time_remaining; }
+
+    /**
+     * @brief Get the request currently held by this server
+     * @return Pointer to the current request, or nullptr if none
+     */
+    const Request* getCurrentRequest() const { return current_request; }
+
+    /**
+     * @brief Overwrite the server state, e.g. when restoring a snapshot
+     * @param is_busy Whether the server is processing a request
+     * @param remaining Clock cycles left on the request
+     * @param req Request held by the server (ownership is transferred), or nullptr
+     */
+    void restoreState(bool is_busy, int remaining, Request* req);
 };
 
 #endif
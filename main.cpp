@@ -12,17 +12,31 @@
  * 2. Enter the number of simulation cycles (100-50000)
  * 3. Watch the simulation run and observe load balancing behavior
  * 4. Review generated log files for analysis
+ * 
+ * Options:
+ *   --restore <file>  Resume from a snapshot instead of starting cold (skips step 1)
+ *   --save <file>     Save a snapshot of the final state
+ *   --stats <file>    Publish live counters to a shared-memory stats page (view with lbstat.exe)
+ *   --quiet           Do not print the per-cycle status line
+ *   --federate <n>    Run n (1-64) balancers on separate threads that share their firewall
+ *                     state, and print throughput and attack detection results
  */
 
 #include <iostream>
 #include <limits>
 #include <fstream>
+#include <cstdlib>
+#include <memory>
+#include <string>
 #include "loadbalancer.h"
+#include "federation.h"
 #include <iomanip> // Required for std::fixed and std::setprecision
 
 /**
  * @brief Main function - Entry point of the load balancer simulation
- * @return 0 on successful execution
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments (see file documentation for options)
+ * @return 0 on successful execution, 1 on invalid arguments or snapshot errors
  * 
  * This function:
  * - Prompts user for simulation parameters
@@ -31,14 +45,55 @@
  * - Generates log files with simulation results
  * - Displays summary statistics
  */
-int main() {
-    int num_servers;
+int main(int argc, char* argv[]) {
+    int num_servers = 0;
     int total_cycles;
+    std::string restore_path;
+    std::string save_path;
+    std::string stats_path;
+    bool quiet = false;
+    int federate_nodes = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--restore" && i + 1 < argc) {
+            restore_path = argv[++i];
+        } else if (arg == "--save" && i + 1 < argc) {
+            save_path = argv[++i];
+        } else if (arg == "--stats" && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else if (arg == "--quiet") {
+            quiet = true;
+        } else if (arg == "--federate" && i + 1 < argc && std::atoi(argv[i + 1]) >= 1 &&
+                   std::atoi(argv[i + 1]) <= MAX_FEDERATION_NODES) {
+            federate_nodes = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--restore <snapshot>] [--save <snapshot>] [--stats <file>] [--quiet] [--federate <nodes>]\n";
+            return 1;
+        }
+    }
+
+    if (federate_nodes > 0 && (!restore_path.empty() || !save_path.empty() || !stats_path.empty())) {
+        std::cerr << "Error: --federate cannot be combined with --restore, --save or --stats\n";
+        return 1;
+    }
 
     std::cout << "===== Load Balancer Simulation =====\n";
     
+    std::unique_ptr<LoadBalancer> restored;
+    if (!restore_path.empty()) {
+        restored.reset(LoadBalancer::fromSnapshot(restore_path));
+        if (!restored) {
+            return 1;
+        }
+        num_servers = restored->getMinServers();
+        std::cout << "Restored snapshot '" << restore_path << "' at cycle " << restored->getCurrentTime()
+                  << " (" << restored->getQueueSize() << " queued requests)\n";
+    }
+
     // Get number of servers with validation
-    do {
+    while (!restored) {
         std::cout << "Enter number of servers (1-50): ";
         std::cin >> num_servers;
         
@@ -54,7 +109,29 @@ int main() {
             continue;
         }
         break;
-    } while (true);
+    }
+
+    if (federate_nodes > 0) {
+        FederationConfig config;
+        config.nodes = federate_nodes;
+        config.servers_per_node = num_servers;
+
+        std::cout << "\nRunning " << config.nodes << " federated balancers with " << num_servers
+                  << " servers each...\n";
+        FederationResult result = runFederation(config);
+
+        std::cout << "\n===== Federation Summary =====\n";
+        std::cout << "Balancers: " << config.nodes << "\n";
+        std::cout << "Front-end requests: " << result.offered << " (" << result.admitted << " admitted)\n";
+        std::cout << "Throughput: " << std::fixed << std::setprecision(0) << result.offered / result.seconds
+                  << " requests/s (admitted requests all served)\n";
+        std::cout << "Attackers blocked: " << result.detected_any << "/" << config.attackers
+                  << " (on every balancer: " << result.detected_all << ")\n";
+        std::cout << "Mean detection latency: " << result.first_detect_us << " us (all balancers: "
+                  << result.full_detect_us << " us)\n";
+        std::cout << "Delta batches sent: " << result.batches_sent << "\n";
+        return 0;
+    }
 
     // Get total clock cycles with validation
     do {
@@ -85,7 +162,15 @@ int main() {
     }
 
     // Use the same number for initial and max servers (allows scaling up to 2x the initial count)
-    LoadBalancer lb(num_servers, num_servers * 2);
+    std::unique_ptr<LoadBalancer> owner(restored ? restored.release() : new LoadBalancer(num_servers, num_servers * 2));
+    LoadBalancer& lb = *owner;
+    lb.setPrintStatus(!quiet);
+    if (!stats_path.empty()) {
+        if (!lb.enableStats(stats_path)) {
+            return 1;
+        }
+        std::cout << "Publishing stats to '" << stats_path << "'\n";
+    }
     
     // Run simulation with logging
     for (int i = 0; i < total_cycles; ++i) {
@@ -102,6 +187,13 @@ int main() {
         std::cout << "\nLog file saved as 'loadbalancer_log.csv'\n";
     }
 
+    if (!save_path.empty()) {
+        if (!lb.saveSnapshot(save_path)) {
+            return 1;
+        }
+        std::cout << "Snapshot saved as '" << save_path << "'\n";
+    }
+
     // Generate summary log file
     std::ofstream summary_log("log.txt");
     if (summary_log.is_open()) {
@@ -0,0 +1,320 @@
+#include "federation.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+FederationLink::FederationLink(int id, int nodes)
+    : node_id(id), outgoing(nodes, nullptr), incoming(nodes, nullptr), backlog(nodes),
+      last_version(nodes, 0), next_version(1), peers(0),
+      batches_sent(0), batches_received(0), version_gaps(0), propagation_ns(0) {}
+
+void FederationLink::connect(int peer, DeltaChannel* out, DeltaChannel* in) {
+    outgoing[peer] = out;
+    incoming[peer] = in;
+    peers++;
+}
+
+void FederationLink::send(const std::shared_ptr<FirewallDelta>& delta) {
+    if (peers == 0) {
+        return;
+    }
+    delta->origin = node_id;
+    delta->version = next_version++;
+    delta->sent_ns = statsClockNs();
+    FirewallDeltaPtr shared(delta);
+
+    for (std::size_t peer = 0; peer < outgoing.size(); ++peer) {
+        if (!outgoing[peer]) continue;
+        // Keep per-peer order: once anything is waiting, queue behind it
+        FirewallDeltaPtr copy(shared);
+        if (!backlog[peer].empty() || !outgoing[peer]->push(copy)) {
+            backlog[peer].push_back(shared);
+        }
+    }
+    batches_sent++;
+}
+
+bool FederationLink::flushBacklog() {
+    bool drained = true;
+    for (std::size_t peer = 0; peer < outgoing.size(); ++peer) {
+        while (!backlog[peer].empty() && outgoing[peer]->push(backlog[peer].front())) {
+            backlog[peer].pop_front();
+        }
+        if (!backlog[peer].empty()) {
+            drained = false;
+        }
+    }
+    return drained;
+}
+
+namespace {
+
+/**
+ * @brief One entry of the front-end request stream
+ */
+struct TrafficEntry {
+    double when;        ///< Position in the stream (entries are sorted by this)
+    int attacker;       ///< Attacker index, or -1 for background traffic
+    std::string ip;     ///< Source IP address
+};
+
+/**
+ * @brief Build the attacker IP for an index
+ * @param index Attacker index
+ * @return Address in the 198.18.0.0/15 benchmarking range
+ */
+std::string attackerIP(int index) {
+    return "198.18." + std::to_string(index / 256) + "." + std::to_string(index % 256);
+}
+
+/**
+ * @brief Build the front-end traffic
+ * @param config Run parameters
+ * @return Entries in the order the front end emits them
+ *
+ * Attackers start at staggered points in the first half of the run and
+ * spread their requests evenly over half of the run, so each one stays well
+ * below the per-IP limit in any short window.
+ */
+std::vector<TrafficEntry> buildTraffic(const FederationConfig& config) {
+    Rng rng(config.seed);
+    std::vector<TrafficEntry> traffic;
+    traffic.reserve(config.background_requests + config.attackers * config.attack_requests);
+
+    for (int i = 0; i < config.background_requests; ++i) {
+        TrafficEntry entry = { static_cast<double>(i), -1, generateRandomIP(rng) };
+        traffic.push_back(entry);
+    }
+
+    double span = config.background_requests / 2.0;
+    double gap = span / std::max(1, config.attack_requests);
+    for (int a = 0; a < config.attackers; ++a) {
+        double start = span * a / std::max(1, config.attackers);
+        std::string ip = attackerIP(a);
+        for (int k = 0; k < config.attack_requests; ++k) {
+            // Jitter so attack requests do not land on a fixed node in the round-robin
+            double jitter = static_cast<double>(rng.uniform(1000)) / 1000.0;
+            TrafficEntry entry = { start + k * gap + jitter, a, ip };
+            traffic.push_back(entry);
+        }
+    }
+
+    std::stable_sort(traffic.begin(), traffic.end(),
+                     [](const TrafficEntry& x, const TrafficEntry& y) { return x.when < y.when; });
+    return traffic;
+}
+
+/**
+ * @brief Per-node state shared between the node thread and the driver
+ */
+struct Node {
+    FederatedLoadBalancer* lb;  ///< The balancer run by this node
+    FederationLink link;        ///< Delta channels to and from peers
+    RequestChannel inbox;       ///< Requests from the front end
+    uint64_t offered;           ///< Front-end requests taken from the inbox
+    uint64_t admitted;          ///< Front-end requests that passed the firewall
+    uint64_t cycles;            ///< Cycles run
+
+    Node(int id, int nodes) : lb(nullptr), link(id, nodes), offered(0), admitted(0), cycles(0) {}
+    ~Node() { delete lb; }
+};
+
+/**
+ * @brief Body of a node thread
+ *
+ * Runs until the front end is done and every admitted request has been served.
+ *
+ * @param node Node to run
+ * @param config Run parameters
+ * @param share Whether the node is connected to peers
+ * @param front_end_done Set by the front end after its last request
+ * @param flushed Number of nodes whose final deltas are all in the channels
+ */
+void runNode(Node& node, const FederationConfig& config, bool share,
+             const std::atomic<bool>& front_end_done, std::atomic<int>& flushed) {
+    FederatedFirewallPolicy<>& firewall = node.lb->getFirewall();
+
+    while (true) {
+        // Read the flag before draining so nothing pushed before it is missed
+        bool done = front_end_done.load(std::memory_order_acquire);
+
+        Request* req = nullptr;
+        for (int taken = 0; taken < config.burst && node.inbox.pop(req); ++taken) {
+            node.offered++;
+            if (node.lb->offerRequest(req)) {
+                node.admitted++;
+            }
+        }
+
+        node.lb->processCycle();
+        node.cycles++;
+
+        if (share) {
+            if (node.cycles % config.flush_interval == 0) {
+                firewall.flush();
+            }
+            firewall.poll();
+        }
+
+        if (done && node.inbox.empty()) {
+            // Serve everything admitted before stopping, so the run time covers all the work
+            if (node.lb->getQueueSize() == 0 && node.lb->getBusyServers() == 0) {
+                break;
+            }
+        } else if (node.inbox.empty()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (share) {
+        // Send the last batch and keep applying peer batches until every node has sent its own
+        firewall.flush();
+        while (!node.link.flushBacklog()) {
+            firewall.poll();
+            std::this_thread::yield();
+        }
+        flushed.fetch_add(1, std::memory_order_acq_rel);
+        while (flushed.load(std::memory_order_acquire) < config.nodes) {
+            firewall.poll();
+            std::this_thread::yield();
+        }
+        firewall.poll();
+    }
+}
+
+/**
+ * @brief Body of the front-end thread
+ * @param traffic Requests to emit, in order
+ * @param nodes Nodes to deal requests to round-robin
+ * @param first_emit Receives the time each attacker's first request was emitted
+ * @param front_end_done Set after the last request is in a node inbox
+ */
+void runFrontEnd(const std::vector<TrafficEntry>& traffic, std::vector<Node*>& nodes,
+                 std::vector<uint64_t>& first_emit, std::atomic<bool>& front_end_done) {
+    std::size_t next = 0;
+    for (const TrafficEntry& entry : traffic) {
+        // Process times 1-10, matching generateRandomRequest()
+        Request* req = new Request(entry.ip, "203.0.113.1", 1 + static_cast<int>(next % 10), 0);
+        RequestChannel& inbox = nodes[next % nodes.size()]->inbox;
+        while (!inbox.push(req)) {
+            std::this_thread::yield();
+        }
+        if (entry.attacker >= 0 && first_emit[entry.attacker] == 0) {
+            first_emit[entry.attacker] = statsClockNs();
+        }
+        next++;
+    }
+    front_end_done.store(true, std::memory_order_release);
+}
+
+} // namespace
+
+FederationResult runFederation(const FederationConfig& config) {
+    FederationResult result = FederationResult();
+    std::vector<TrafficEntry> traffic = buildTraffic(config);
+
+    std::map<std::string, int> attacker_index;
+    for (int a = 0; a < config.attackers; ++a) {
+        attacker_index[attackerIP(a)] = a;
+    }
+
+    // Simulation output (status lines, firewall and scaling messages) is not useful here
+    std::streambuf* saved_cout = std::cout.rdbuf(nullptr);
+
+    std::vector<Node*> nodes;
+    for (int i = 0; i < config.nodes; ++i) {
+        Node* node = new Node(i, config.nodes);
+        node->lb = new FederatedLoadBalancer(config.servers_per_node, config.servers_per_node * 2,
+                                             config.seed + 1 + i, false);
+        node->lb->setPrintStatus(false);
+        nodes.push_back(node);
+    }
+
+    // One channel per ordered pair of nodes; a single node has no one to share with
+    bool share = config.share && config.nodes > 1;
+    std::vector<DeltaChannel*> channels(config.nodes * config.nodes, nullptr);
+    if (share) {
+        for (int from = 0; from < config.nodes; ++from) {
+            for (int to = 0; to < config.nodes; ++to) {
+                if (from != to) channels[from * config.nodes + to] = new DeltaChannel();
+            }
+        }
+        for (int i = 0; i < config.nodes; ++i) {
+            for (int peer = 0; peer < config.nodes; ++peer) {
+                if (peer == i) continue;
+                nodes[i]->link.connect(peer, channels[i * config.nodes + peer], channels[peer * config.nodes + i]);
+            }
+            nodes[i]->lb->getFirewall().attach(&nodes[i]->link);
+        }
+    }
+
+    std::vector<uint64_t> first_emit(config.attackers, 0);
+    std::atomic<bool> front_end_done(false);
+    std::atomic<int> flushed(0);
+
+    uint64_t start_ns = statsClockNs();
+    std::vector<std::thread> threads;
+    for (Node* node : nodes) {
+        threads.push_back(std::thread(runNode, std::ref(*node), std::cref(config), share,
+                                      std::cref(front_end_done), std::ref(flushed)));
+    }
+    std::thread front_end(runFrontEnd, std::cref(traffic), std::ref(nodes),
+                          std::ref(first_emit), std::ref(front_end_done));
+    front_end.join();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    result.seconds = (statsClockNs() - start_ns) / 1e9;
+
+    std::cout.rdbuf(saved_cout);
+
+    // Detection latency: time from an attacker's first request to its block on each node
+    std::vector<uint64_t> first_block(config.attackers, 0);
+    std::vector<uint64_t> full_block(config.attackers, 0);
+    std::vector<int> blocked_on(config.attackers, 0);
+    uint64_t propagation_ns = 0;
+    uint64_t batches_received = 0;
+    for (Node* node : nodes) {
+        result.offered += node->offered;
+        result.admitted += node->admitted;
+        result.cycles += node->cycles;
+        result.batches_sent += node->link.batches_sent;
+        result.version_gaps += node->link.version_gaps;
+        propagation_ns += node->link.propagation_ns;
+        batches_received += node->link.batches_received;
+
+        for (const auto& entry : node->lb->getFirewall().getBlockLog()) {
+            std::map<std::string, int>::const_iterator it = attacker_index.find(entry.first);
+            if (it == attacker_index.end()) continue;
+            int a = it->second;
+            if (first_block[a] == 0 || entry.second < first_block[a]) first_block[a] = entry.second;
+            full_block[a] = std::max(full_block[a], entry.second);
+            blocked_on[a]++;
+        }
+    }
+
+    double first_sum = 0;
+    double full_sum = 0;
+    for (int a = 0; a < config.attackers; ++a) {
+        if (blocked_on[a] == 0) continue;
+        result.detected_any++;
+        first_sum += (first_block[a] - first_emit[a]) / 1e3;
+        if (blocked_on[a] == config.nodes) {
+            double full_us = (full_block[a] - first_emit[a]) / 1e3;
+            result.detected_all++;
+            full_sum += full_us;
+            result.max_full_detect_us = std::max(result.max_full_detect_us, full_us);
+        }
+    }
+    result.first_detect_us = result.detected_any ? first_sum / result.detected_any : 0;
+    result.full_detect_us = result.detected_all ? full_sum / result.detected_all : 0;
+    result.mean_propagation_us = batches_received ? propagation_ns / 1e3 / batches_received : 0;
+
+    for (Node* node : nodes) {
+        delete node;
+    }
+    for (DeltaChannel* channel : channels) {
+        delete channel;
+    }
+    return result;
+}
@@ -0,0 +1,21 @@
+#include "policies.h"
+
+bool isReservedIPRange(const std::string& ip) {
+    // Block certain IP ranges (simulating firewall rules)
+    // Block 192.168.x.x (private network)
+    if (ip.length() >= 8 && ip.substr(0, 8) == "192.168.") {
+        return true;
+    }
+    
+    // Block 10.x.x.x (private network)
+    if (ip.length() >= 3 && ip.substr(0, 3) == "10.") {
+        return true;
+    }
+    
+    // Block 127.x.x.x (localhost)
+    if (ip.length() >= 4 && ip.substr(0, 4) == "127.") {
+        return true;
+    }
+    
+    return false;
+}
@@ -0,0 +1,206 @@
+#include "snapshot.h"
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char SNAPSHOT_MAGIC[8] = { 'L', 'B', 'S', 'N', 'A', 'P', 0, 0 };
+
+MappedFile::MappedFile() : bytes(nullptr), length(0) {}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (bytes && buffer.empty()) {
+        munmap(const_cast<char*>(bytes), length);
+    }
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after the descriptor is closed
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    file->bytes = static_cast<const char*>(addr);
+    file->length = static_cast<std::size_t>(st.st_size);
+#else
+    // No mmap: read the whole file into memory instead
+    std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return nullptr;
+    }
+    std::streamoff file_size = in.tellg();
+    if (file_size <= 0) {
+        return nullptr;
+    }
+    file->buffer.resize(static_cast<std::size_t>(file_size));
+    in.seekg(0);
+    if (!in.read(&file->buffer[0], file_size)) {
+        return nullptr;
+    }
+    file->bytes = &file->buffer[0];
+    file->length = file->buffer.size();
+#endif
+
+    return file;
+}
+
+const SnapshotHeader* readSnapshotHeader(const MappedFile& file) {
+    const SnapshotHeader* header = file.at<SnapshotHeader>(0, 1);
+    if (!header) {
+        return nullptr;
+    }
+
+    // Reject other formats and builds with a different record layout
+    if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header->version != SNAPSHOT_VERSION ||
+        header->header_size != sizeof(SnapshotHeader) ||
+        header->server_record_size != sizeof(ServerRecord) ||
+        header->request_record_size != sizeof(RequestRecord) ||
+        header->ip_count_record_size != sizeof(IPCountRecord) ||
+        header->ip_record_size != sizeof(IPRecord)) {
+        return nullptr;
+    }
+
+    if (header->current_time < 0 || header->min_servers < 0 || header->min_servers > header->max_servers) {
+        return nullptr;
+    }
+
+    return header;
+}
+
+void initSnapshotHeader(SnapshotHeader& header) {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(SnapshotHeader);
+    header.server_record_size = sizeof(ServerRecord);
+    header.request_record_size = sizeof(RequestRecord);
+    header.ip_count_record_size = sizeof(IPCountRecord);
+    header.ip_record_size = sizeof(IPRecord);
+}
+
+uint64_t alignSnapshot(std::ofstream& out) {
+    static const char padding[8] = { 0 };
+    uint64_t offset = static_cast<uint64_t>(out.tellp());
+    uint64_t pad = (8 - offset % 8) % 8;
+    out.write(padding, static_cast<std::streamsize>(pad));
+    return offset + pad;
+}
+
+void packIP(const std::string& ip, char* field) {
+    std::size_t len = std::min(ip.length(), SNAPSHOT_IP_LEN - 1);
+    std::memcpy(field, ip.data(), len);
+    std::memset(field + len, 0, SNAPSHOT_IP_LEN - len);
+}
+
+void packRequest(const Request& req, RequestRecord& rec) {
+    packIP(req.ip_in, rec.ip_in);
+    packIP(req.ip_out, rec.ip_out);
+    rec.process_time = req.process_time;
+    rec.arrival_time = req.arrival_time;
+    rec.assigned_time = req.assigned_time;
+    rec.processed = req.processed ? 1 : 0;
+}
+
+Request* unpackRequest(const RequestRecord& rec) {
+    Request* req = new Request(std::string(rec.ip_in, strnlen(rec.ip_in, SNAPSHOT_IP_LEN)),
+                               std::string(rec.ip_out, strnlen(rec.ip_out, SNAPSHOT_IP_LEN)),
+                               rec.process_time, rec.arrival_time);
+    req->assigned_time = rec.assigned_time;
+    req->processed = rec.processed != 0;
+    return req;
+}
+
+void packServer(const WebServer& server, ServerRecord& rec) {
+    std::memset(&rec, 0, sizeof(rec));
+    rec.busy = server.isBusy() ? 1 : 0;
+    rec.time_remaining = server.getTimeRemaining();
+    if (server.getCurrentRequest()) {
+        rec.has_request = 1;
+        packRequest(*server.getCurrentRequest(), rec.request);
+    }
+}
+
+bool isValidRequestRecord(const RequestRecord& rec) {
+    return rec.process_time >= 1 && rec.process_time <= MAX_PROCESS_TIME;
+}
+
+bool isValidServerRecord(const ServerRecord& rec) {
+    if (rec.time_remaining < 0 || (rec.has_request && !isValidRequestRecord(rec.request))) {
+        return false;
+    }
+    if (rec.busy) {
+        // A busy server must hold the request it is counting down
+        return rec.has_request && rec.time_remaining > 0 && rec.time_remaining <= rec.request.process_time;
+    }
+    // An idle server may only hold a finished request waiting to be collected
+    return !rec.has_request || rec.request.processed;
+}
+
+WebServer* unpackServer(const ServerRecord& rec) {
+    WebServer* server = new WebServer();
+    server->restoreState(rec.busy != 0, rec.time_remaining,
+                         rec.has_request ? unpackRequest(rec.request) : nullptr);
+    return server;
+}
+
+int compareIP(const std::string& ip, const char* field) {
+    return ip.compare(0, std::string::npos, field, strnlen(field, SNAPSHOT_IP_LEN));
+}
+
+static bool ipCountLess(const IPCountRecord& rec, const std::string& ip) {
+    return compareIP(ip, rec.ip) > 0;
+}
+
+static bool ipLess(const IPRecord& rec, const std::string& ip) {
+    return compareIP(ip, rec.ip) > 0;
+}
+
+const IPCountRecord* findIPCount(const IPCountRecord* records, std::size_t count, const std::string& ip) {
+    const IPCountRecord* end = records + count;
+    const IPCountRecord* it = std::lower_bound(records, end, ip, ipCountLess);
+    if (it != end && compareIP(ip, it->ip) == 0) {
+        return it;
+    }
+    return nullptr;
+}
+
+bool containsIP(const IPRecord* records, std::size_t count, const std::string& ip) {
+    const IPRecord* end = records + count;
+    const IPRecord* it = std::lower_bound(records, end, ip, ipLess);
+    return it != end && compareIP(ip, it->ip) == 0;
+}
+
+bool replaceSnapshotFile(const std::string& tmp_path, const std::string& path) {
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename() does not overwrite on Windows
+#endif
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+#include "stats.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+uint64_t statsClockNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t statsProcessId() {
+#ifndef _WIN32
+    return static_cast<uint64_t>(getpid());
+#else
+    return 0;
+#endif
+}
+
+bool readStats(const StatsPage& page, StatsSample& sample, int max_retries) {
+    uint64_t* dst = reinterpret_cast<uint64_t*>(&sample);
+
+    for (int attempt = 0; attempt < max_retries; ++attempt) {
+        uint64_t before = page.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue; // Write in progress
+        }
+        for (std::size_t i = 0; i < STATS_WORDS; ++i) {
+            dst[i] = page.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (page.sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+StatsPublisher::~StatsPublisher() {
+#ifndef _WIN32
+    if (page) {
+        StatsSample sample;
+        if (readStats(*page, sample)) {
+            sample.active = 0;
+            publish(sample);
+        }
+        munmap(page, sizeof(StatsPage));
+    }
+#endif
+}
+
+bool StatsPublisher::open(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open stats page " << path << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, sizeof(StatsPage)) != 0) {
+        std::cerr << "Error: Could not size stats page " << path << std::endl;
+        close(fd);
+        return false;
+    }
+
+    void* addr = mmap(nullptr, sizeof(StatsPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping stays valid after the descriptor is closed
+    if (addr == MAP_FAILED) {
+        std::cerr << "Error: Could not map stats page " << path << std::endl;
+        return false;
+    }
+
+    // Reset the page; readers ignore it until the magic is written
+    page = static_cast<StatsPage*>(addr);
+    page->magic.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page->words_count.store(STATS_WORDS, std::memory_order_relaxed);
+    page->sequence.store(0, std::memory_order_relaxed);
+    StatsSample empty;
+    std::memset(&empty, 0, sizeof(empty));
+    empty.pid = statsProcessId();
+    empty.active = 1;
+    publish(empty);
+    page->magic.store(STATS_MAGIC, std::memory_order_release);
+    return true;
+#else
+    std::cerr << "Error: Shared-memory stats are not supported on this platform" << std::endl;
+    return false;
+#endif
+}
@@ -2,10 +2,6 @@
 
 WebServer::WebServer() : busy(false), time_remaining(0), current_request(nullptr) {}
 
-bool WebServer::isBusy() const {
-    return busy;
-}
-
 void WebServer::assignRequest(Request* req, int current_time) {
     if (!busy) {
         current_request = req;
@@ -15,20 +11,6 @@ void WebServer::assignRequest(Request* req, int current_time) {
     }
 }
 
-void WebServer::processCycle() {
-    if (busy && time_remaining > 0) {
-        time_remaining--;
-        if (time_remaining == 0) {
-            busy = false;
-            current_request->processed = true;
-        }
-    }
-}
-
-bool WebServer::isRequestDone() const {
-    return !busy && current_request != nullptr && current_request->processed;
-}
-
 Request* WebServer::finishRequest() {
     Request* finished = current_request;
     current_request = nullptr;
@@ -38,3 +20,9 @@ Request* WebServer::finishRequest() {
     }
     return finished;
 }
+
+void WebServer::restoreState(bool is_busy, int remaining, Request* req) {
+    busy = is_busy;
+    time_remaining = remaining;
+    current_request = req;
+}
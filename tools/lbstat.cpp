@@ -0,0 +1,132 @@
+/**
+ * @file lbstat.cpp
+ * @brief Live viewer for the shared-memory stats page of a running simulation
+ *
+ * Maps the stats page read-only and prints one line per interval with
+ * queue and server counters, firewall counters, admission/dispatch rates
+ * and the moving-average duration of each processCycle() phase. Never
+ * writes to the page, so it does not disturb the simulation.
+ *
+ * Usage: lbstat.exe [path] [interval_ms] [count]
+ *   path         Stats file passed to loadbalancer.exe --stats (default: /dev/shm/loadbalancer_stats)
+ *   interval_ms  Time between samples (default: 1000)
+ *   count        Number of samples to print, 0 for unlimited (default: 0)
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "stats.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Print the column headings
+ */
+static void printHeader() {
+    std::cout << std::setw(8) << "cycle" << std::setw(10) << "cyc/s"
+              << std::setw(8) << "queue" << std::setw(10) << "busy/tot"
+              << std::setw(9) << "blocked" << std::setw(6) << "ips"
+              << std::setw(9) << "adm/cyc" << std::setw(9) << "dsp/cyc"
+              << std::setw(9) << "add ns" << std::setw(9) << "asgn ns"
+              << std::setw(9) << "proc ns" << std::setw(9) << "scale ns" << "\n";
+}
+
+/**
+ * @brief Print one sample
+ * @param sample Current sample
+ * @param cycles_per_sec Simulation speed since the previous sample
+ */
+static void printSample(const StatsSample& sample, double cycles_per_sec) {
+    std::cout << std::setw(8) << sample.cycle
+              << std::setw(10) << std::fixed << std::setprecision(0) << cycles_per_sec
+              << std::setw(8) << sample.queue_size
+              << std::setw(5) << sample.busy_servers << "/" << std::left << std::setw(4) << sample.total_servers << std::right
+              << std::setw(9) << sample.blocked_requests
+              << std::setw(6) << sample.blocked_ips
+              << std::setw(9) << std::setprecision(3) << sample.admission_rate_milli / 1000.0
+              << std::setw(9) << sample.dispatch_rate_milli / 1000.0;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        std::cout << std::setw(9) << sample.phase_avg_ns[p];
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+#ifndef _WIN32
+    std::string path = argc > 1 ? argv[1] : "/dev/shm/loadbalancer_stats";
+    int interval_ms = argc > 2 ? std::atoi(argv[2]) : 1000;
+    int count = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(StatsPage)) {
+        std::cerr << "Error: No stats page at " << path << std::endl;
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    void* addr = mmap(nullptr, sizeof(StatsPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Error: Could not map stats page " << path << std::endl;
+        return 1;
+    }
+    const StatsPage& page = *static_cast<const StatsPage*>(addr);
+
+    if (page.magic.load(std::memory_order_acquire) != STATS_MAGIC ||
+        page.words_count.load(std::memory_order_relaxed) != STATS_WORDS) {
+        std::cerr << "Error: " << path << " is not a compatible stats page" << std::endl;
+        munmap(addr, sizeof(StatsPage));
+        return 1;
+    }
+
+    StatsSample sample;
+    uint64_t last_cycle = 0;
+    auto last_time = std::chrono::steady_clock::now();
+    bool first = true;
+
+    int printed = 0;
+    while (count == 0 || printed < count) {
+        if (!readStats(page, sample)) {
+            std::cerr << "Warning: could not get a consistent sample" << std::endl;
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - last_time).count();
+        double cycles_per_sec = (!first && elapsed > 0) ? (sample.cycle - last_cycle) / elapsed : 0;
+
+        if (printed % 20 == 0) {
+            if (first) std::cout << "Publisher PID " << sample.pid << "\n";
+            printHeader();
+        }
+        printSample(sample, cycles_per_sec);
+        printed++;
+
+        if (!sample.active) {
+            std::cout << "Publisher has stopped." << std::endl;
+            break;
+        }
+
+        first = false;
+        last_cycle = sample.cycle;
+        last_time = now;
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+
+    munmap(addr, sizeof(StatsPage));
+    return 0;
+#else
+    std::cerr << "Error: Shared-memory stats are not supported on this platform" << std::endl;
+    return 1;
+#endif
+}